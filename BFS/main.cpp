@@ -1,9 +1,12 @@
 #include<stdio.h>
 #include<stdlib.h>
-#include "Profiler.h"
+#define PROFILER_TRACK_ALLOCATIONS
+#include "../Profiler/Profiler.h"
 
 #define VARRY_E "Computational Effort Varry E"
 #define VARRY_V "Computational Effort Varry V"
+#define MEMORY_E "Memory Varry E"
+#define MEMORY_V "Memory Varry V"
 
 Profiler profiler("BFS");
 
@@ -43,7 +46,7 @@ Profiler profiler("BFS");
 */
 
 enum Color { Black = 0, White = 1, Grey = 2 };
-int OP;
+thread_local unsigned long long OP;
 
 typedef struct nodeL {
 	struct nodeG* key;
@@ -198,8 +201,9 @@ NodeQ* dequeue(Queue* Q) {
 }
 
 NodeG** createGraph(int V, int E) {
-	srand(time(0));
 	NodeG** nodes = (NodeG**)malloc(V * sizeof(NodeG*));
+	int* ends = (int*)malloc(2 * E * sizeof(int)); // candidate edges, generated in parallel
+	int used = 2 * E;
 
 	for (int i = 0; i < V; i++)
 	{
@@ -209,8 +213,14 @@ NodeG** createGraph(int V, int E) {
 	int nbOfEdges = 0;
 	while (nbOfEdges < E)
 	{
-		int indexA = rand() % V;
-		int indexB = rand() % V;
+		if (used == 2 * E)
+		{
+			FillRandomArray(ends, 2 * E, 0, V - 1);
+			used = 0;
+		}
+
+		int indexA = ends[used++];
+		int indexB = ends[used++];
 
 		if (indexA != indexB && !checkForEdge(nodes[indexA], nodes[indexB]))
 		{
@@ -221,6 +231,8 @@ NodeG** createGraph(int V, int E) {
 		}
 	}
 
+	free(ends);
+
 	return nodes;
 }
 
@@ -235,18 +247,19 @@ bool allBlacks(NodeQ** Qnodes, int size) {
 	return true;
 }
 
+template <typename Count>
 void BFS(NodeG** nodes, int size) {
 	int* indexes = (int*)malloc(size * sizeof(int));
 	FillRandomArray(indexes, size, 0, size - 1, true, 0);
 
 	NodeQ** Qnodes = (NodeQ**)malloc(size * sizeof(NodeQ*));
 	Queue* Q = createQueue();
-	OP++;
+	Count::add(OP);
 
 	for (int i = 0; i < size; i++)
 	{
 		Qnodes[i] = createNodeQ(nodes[i]);
-		OP++;
+		Count::add(OP);
 	}
 
 	int index = 0;
@@ -258,16 +271,16 @@ void BFS(NodeG** nodes, int size) {
 		}
 
 		Qnodes[indexes[index]]->color = Grey;
-		OP++;
+		Count::add(OP);
 		enqueue(Q, Qnodes[indexes[index]]);
-		OP++;
+		Count::add(OP);
 
 		while (Q->size > 0)
 		{
 			NodeQ* node = dequeue(Q);
-			OP++;
+			Count::add(OP);
 			node->color = Black;
-			OP++;
+			Count::add(OP);
 
 			NodeL* curr = node->key->list;
 
@@ -276,11 +289,11 @@ void BFS(NodeG** nodes, int size) {
 				if (Qnodes[curr->key->key - 1]->color == White)
 				{
 					Qnodes[curr->key->key - 1]->color = Grey;
-					OP++;
+					Count::add(OP);
 					enqueue(Q, Qnodes[curr->key->key - 1]);
-					OP++;
+					Count::add(OP);
 				}
-				OP++;
+				Count::add(OP);
 
 				curr = curr->next;
 			}
@@ -423,40 +436,50 @@ void BFSDemo() {
 
 void generateChartVarryE() {
 	int V = 100;
-	int E;
-	NodeG** nodes;
 
-	for (E = 1000; E <= 5000; E += 100)
-	{
+	ParallelSweep(1000, 5000, 100, [&](int E) {
+		NodeG** nodes;
+
 		OP = 0;
 
+		profiler.startAllocations(MEMORY_E, E);
 		nodes = createGraph(V, E);
 
-		BFS(nodes, V);
+		BFS<CountingPolicy>(nodes, V);
+		profiler.stopAllocations(MEMORY_E, E);
+
+		profiler.startTimer(VARRY_E, E);
+		BFS<NullPolicy>(nodes, V);
+		profiler.stopTimer(VARRY_E, E);
 
 		freeGraph(nodes, V);
 
 		profiler.countOperation(VARRY_E, E, OP);
-	}
+	});
 }
 
 void generateChartVarryV() {
-	int V;
 	int E = 9000;
-	NodeG** nodes;
 
-	for (V = 100; V <= 200; V += 10)
-	{
+	ParallelSweep(100, 200, 10, [&](int V) {
+		NodeG** nodes;
+
 		OP = 0;
 
+		profiler.startAllocations(MEMORY_V, V);
 		nodes = createGraph(V, E);
 
-		BFS(nodes, V);
+		BFS<CountingPolicy>(nodes, V);
+		profiler.stopAllocations(MEMORY_V, V);
+
+		profiler.startTimer(VARRY_V, V);
+		BFS<NullPolicy>(nodes, V);
+		profiler.stopTimer(VARRY_V, V);
 
 		freeGraph(nodes, V);
 
 		profiler.countOperation(VARRY_V, V, OP);
-	}
+	});
 }
 
 void generateCharts() {
@@ -464,11 +487,18 @@ void generateCharts() {
 
 	generateChartVarryV();
 
+	profiler.createGroup("Graph Memory Varry E", MEMORY_E " bytes", MEMORY_E " peak bytes");
+	profiler.createGroup("Graph Memory Varry V", MEMORY_V " bytes", MEMORY_V " peak bytes");
+
 	profiler.showReport();
 }
 
-void main() {
+#ifndef BENCHMARK_DRIVER
+int main() {
 	BFSDemo();
 	
 	generateCharts();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
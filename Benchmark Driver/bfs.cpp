@@ -0,0 +1,45 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace BreadthFirstSearch {
+#include "../BFS/main.cpp"
+
+struct Graph {
+	NodeG** nodes;
+	int V;
+};
+
+Graph makeGraph(int V, int E) {
+	Graph input;
+
+	input.nodes = createGraph(V, E);
+	input.V = V;
+
+	return input;
+}
+
+bool registerBenchmarks() {
+	RegisterBenchmark<Graph>("BFS", "Vary E")
+		.sizes(1000, 5000, 100)
+		.input("V = 100", [](int E) { return makeGraph(100, E); })
+		.release([](Graph& input, int) { freeGraph(input.nodes, input.V); })
+		.reset([]() { OP = 0; })
+		.algorithm("BFS", [](Graph& input, int) { BFS<CountingPolicy>(input.nodes, input.V); },
+			[](Graph& input, int) { BFS<NullPolicy>(input.nodes, input.V); })
+		.metric("operations", []() { return (double)OP; });
+
+	RegisterBenchmark<Graph>("BFS", "Vary V")
+		.sizes(100, 200, 10)
+		.input("E = 9000", [](int V) { return makeGraph(V, 9000); })
+		.release([](Graph& input, int) { freeGraph(input.nodes, input.V); })
+		.reset([]() { OP = 0; })
+		.algorithm("BFS", [](Graph& input, int) { BFS<CountingPolicy>(input.nodes, input.V); },
+			[](Graph& input, int) { BFS<NullPolicy>(input.nodes, input.V); })
+		.metric("operations", []() { return (double)OP; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
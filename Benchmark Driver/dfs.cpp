@@ -0,0 +1,54 @@
+#include <stack>
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace DepthFirstSearch {
+#include "../DFS/main.cpp"
+
+struct Graph {
+	NodeG** nodes;
+	int V;
+};
+
+Graph makeGraph(int V, int E) {
+	Graph input;
+
+	input.nodes = createGraph(V, E);
+	input.V = V;
+
+	return input;
+}
+
+void countedDFS(Graph& input, int) {
+	TIME = 0;
+	DFS<CountingPolicy>(input.nodes, input.V, false, false);
+}
+
+void timedDFS(Graph& input, int) {
+	TIME = 0;
+	DFS<NullPolicy>(input.nodes, input.V, false, false);
+}
+
+bool registerBenchmarks() {
+	RegisterBenchmark<Graph>("DFS", "Vary E")
+		.sizes(1000, 5000, 100)
+		.input("V = 100", [](int E) { return makeGraph(100, E); })
+		.release([](Graph& input, int) { freeGraph(input.nodes, input.V); })
+		.reset([]() { OP = 0; })
+		.algorithm("DFS", countedDFS, timedDFS)
+		.metric("operations", []() { return (double)OP; });
+
+	RegisterBenchmark<Graph>("DFS", "Vary V")
+		.sizes(100, 200, 10)
+		.input("E = 9000", [](int V) { return makeGraph(V, 9000); })
+		.release([](Graph& input, int) { freeGraph(input.nodes, input.V); })
+		.reset([]() { OP = 0; })
+		.algorithm("DFS", countedDFS, timedDFS)
+		.metric("operations", []() { return (double)OP; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
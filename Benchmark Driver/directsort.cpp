@@ -0,0 +1,23 @@
+#include <iostream>
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace DirectSort {
+#include "../Direct Sort Methods/main.cpp"
+
+bool registerBenchmarks() {
+	RegisterSortBenchmark("Direct Sort Methods", "Direct Sort")
+		.sizes(500, 10000, 500)
+		.reset(initAssigComp)
+		.algorithm("Bubble Sort", [](int*& a, int size) { bubbleSort<CountingPolicy>(a, size); })
+		.algorithm("Insertion Sort", [](int*& a, int size) { insertionSort<CountingPolicy>(a, size); })
+		.algorithm("Selection Sort", [](int*& a, int size) { selectionSort<CountingPolicy>(a, size); })
+		.metric("assignments", []() { return (double)(BUB_A + INS_A + SEL_A); })
+		.metric("comparisons", []() { return (double)(BUB_C + INS_C + SEL_C); });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
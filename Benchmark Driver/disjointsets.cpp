@@ -0,0 +1,51 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace DisjointSets {
+#include "../Disjoint Sets/main.cpp"
+
+/**
+* a graph of V nodes and 4V weighted edges, every node in a set of its own
+*/
+struct WeightedGraph {
+	Node** sets;
+	Edge* edges;
+	int** adjMatrix;
+};
+
+bool registerBenchmarks() {
+	RegisterBenchmark<WeightedGraph>("Disjoint Sets", "Kruskal")
+		.sizes(100, 10000, 100)
+		.setup([]() { maxWeight = 50000; })
+		.input("E = 4V", [](int size) {
+			WeightedGraph input;
+
+			input.sets = createDisjointSets<CountingPolicy>(size); // MakeSet is part of the effort
+			input.adjMatrix = createAdjacencyMatrix(size);
+			input.edges = getEdgesSorted(input.sets, input.adjMatrix, size);
+
+			return input;
+		})
+		.release([](WeightedGraph& input, int size) {
+			freeDisjointSets(input.sets, size);
+			free(input.edges);
+			freeMatrix(input.adjMatrix, size);
+		})
+		.reset([]() { OP = 0; })
+		.algorithm("set operations", [](WeightedGraph& input, int size) {
+			for (int i = 0; i < 4 * size; i++)
+			{
+				if (findSet<CountingPolicy>(input.edges[i].src) != findSet<CountingPolicy>(input.edges[i].dest))
+				{
+					combineSets<CountingPolicy>(findSet<CountingPolicy>(input.edges[i].src), findSet<CountingPolicy>(input.edges[i].dest));
+				}
+			}
+		})
+		.metric("operations", []() { return (double)OP; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
@@ -0,0 +1,60 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace HashTables {
+#include "../Hash Tables/main.cpp"
+
+const int TABLE_SIZE = 10007;
+const int PROBE_COUNT = 1500;
+
+/**
+* a table filled up to the load factor and the keys searched in it
+*/
+struct FilledTable {
+	Entry** table;
+	int* found;
+	int* notFound;
+};
+
+bool registerBenchmarks() {
+	RegisterBenchmark<FilledTable>("Hash Tables", "Search")
+		.sizes(80, 99, 1, "load factor %")
+		.input("quadratic probing", [](int ratio) {
+			FilledTable input;
+			int elements = getSizeByRatio(ratio, TABLE_SIZE);
+			int* sample = (int*)malloc(elements * sizeof(int));
+
+			input.table = createHashTable(TABLE_SIZE);
+			input.found = (int*)malloc(PROBE_COUNT * sizeof(int));
+			input.notFound = (int*)malloc(PROBE_COUNT * sizeof(int));
+
+			createSampleInput(elements, PROBE_COUNT, sample, input.found, input.notFound);
+			fillHashTable(input.table, TABLE_SIZE, sample, elements);
+			free(sample);
+
+			return input;
+		})
+		.release([](FilledTable& input, int) {
+			freeHashTable(input.table, TABLE_SIZE);
+			free(input.found);
+			free(input.notFound);
+		})
+		.algorithm("found", [](FilledTable& input, int) {
+			Profiler::Histogram probes;
+			searchFound(input.table, TABLE_SIZE, input.found, PROBE_COUNT, probes);
+		})
+		.algorithm("not found", [](FilledTable& input, int) {
+			Profiler::Histogram probes;
+			searchNotFound(input.table, TABLE_SIZE, input.notFound, PROBE_COUNT, probes);
+		})
+		// the runner keeps fractions, so the average is the real curve and not rounded to 1 or 2
+		.metric("average probes", []() { return (double)EFFORT / PROBE_COUNT; })
+		.metric("total probes", []() { return (double)EFFORT; })
+		.metric("max probes", []() { return (double)MAX_EFFORT; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
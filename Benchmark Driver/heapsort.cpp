@@ -0,0 +1,22 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace HeapSort {
+#include "../Heap Sort/main.cpp"
+
+bool registerBenchmarks() {
+	RegisterSortBenchmark("Heap Sort", "Build Heap", 10, 20)
+		.sizes(100, 9900, 100)
+		.reset(initOperations)
+		.algorithm("Bottom-Up", [](int*& a, int size) { buildHeapBottomUp<CountingPolicy>(a, size, false); },
+			[](int*& a, int size) { buildHeapBottomUp<NullPolicy>(a, size, false); })
+		.algorithm("Top-Down", [](int*& a, int size) { buildHeapTopDown<CountingPolicy>(a, size, false); },
+			[](int*& a, int size) { buildHeapTopDown<NullPolicy>(a, size, false); })
+		.metric("operations", []() { return (double)(TOP_DOWN_OP + BOTTOM_UP_OP); });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
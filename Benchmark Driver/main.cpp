@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../Profiler/Benchmark.h"
+
+/*
+	Benchmark Driver
+	----------------
+		One program for the charts of all the modules. Every file of this directory includes the main.cpp of one module
+	  (in a namespace of its own, without its main) and registers the benchmarks of that module: the algorithms, the inputs
+	  they run on, the default range of sizes and the metrics read after every run. The driver picks the benchmarks from the
+	  command line, runs them and writes one report per module.
+
+		Usage
+			benchmark [options]
+				--list                   prints the modules and benchmarks, then stops
+				--module a,b,...         runs only these modules (default: all of them)
+				--benchmark a,b,...      runs only these benchmarks of the modules
+				--sizes first:last:step  replaces the size range of every benchmark whose sizes are element counts,
+				                         the others (the load factor of Hash Tables) keep their own
+				--threads n              sweep threads, 0 is one per core (default)
+				--pin                    binds sweep thread i to core i
+				--seed n                 seed of the inputs (default: taken from the clock)
+				--format html,json,csv,trace
+				                         formats of the reports (default: html)
+				--output prefix          the reports are named <prefix><module> instead of report-<module>-<time>
+				--hardware               adds the hardware counter series of the timed runs
+
+			Names are matched ignoring the case, the spaces and the dashes, "--module heapsort,quicksort" is enough;
+		  a name that matches no module (or no benchmark of the selected modules) is a bad command line.
+			Every benchmark is seeded with the same seed, so its inputs do not depend on which other benchmarks run.
+			The exit code is 0 if every report was written without regressions (see PROFILER_BASELINE), 1 otherwise
+		  (a benchmark that fails is reported on stderr, the others still run) and 2 for a bad command line.
+*/
+
+// Build, from the root of the repository: "cmake -S . -B build && cmake --build build" builds the driver and every module,
+// or by hand (Linux): the driver, the profiler and the sources of the modules besides their main.cpp
+//	g++ -std=c++17 -O2 -pthread "Benchmark Driver"/*.cpp Profiler/Profiler.cpp Profiler/Benchmark.cpp "Merge K Sroted Lists/lists.cpp" -o benchmark
+
+struct Options {
+	bool list;
+	std::vector<std::string> modules;
+	std::vector<std::string> benchmarks;
+	bool customSizes;
+	long long first, last, step;
+	int threads;
+	bool pin;
+	bool customSeed;
+	unsigned long long seed;
+	int formats;
+	std::string output;
+	bool hardware;
+};
+
+std::vector<std::string> splitList(const char* list) {
+	std::vector<std::string> names;
+	std::string name;
+
+	for (const char* c = list; ; ++c)
+	{
+		if (*c == ',' || *c == '\0')
+		{
+			if (!name.empty())
+			{
+				names.push_back(name);
+			}
+			name.clear();
+
+			if (*c == '\0')
+			{
+				return names;
+			}
+		}
+		else
+		{
+			name += *c;
+		}
+	}
+}
+
+bool selected(const std::vector<std::string>& names, const std::string& name) {
+	if (names.empty())
+	{
+		return true;
+	}
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		if (Benchmark::matches(name, names[i].c_str()))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int parseFormats(const char* list) {
+	std::vector<std::string> names = splitList(list);
+	int formats = 0;
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		if (names[i] == "html")
+		{
+			formats |= Profiler::REPORT_HTML;
+		}
+		else if (names[i] == "json")
+		{
+			formats |= Profiler::REPORT_JSON;
+		}
+		else if (names[i] == "csv")
+		{
+			formats |= Profiler::REPORT_CSV;
+		}
+		else if (names[i] == "trace")
+		{
+			formats |= Profiler::REPORT_TRACE;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+
+	return formats;
+}
+
+void printUsage() {
+	fprintf(stderr, "usage: benchmark [--list] [--module a,b] [--benchmark a,b] [--sizes first:last:step] [--threads n] [--pin]\n");
+	fprintf(stderr, "                 [--seed n] [--format html,json,csv,trace] [--output prefix] [--hardware]\n");
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+	options.list = false;
+	options.customSizes = false;
+	options.first = options.last = options.step = 0;
+	options.threads = 0;
+	options.pin = false;
+	options.customSeed = false;
+	options.seed = 0;
+	options.formats = Profiler::REPORT_HTML;
+	options.hardware = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string option = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+
+		if (option == "--list")
+		{
+			options.list = true;
+		}
+		else if (option == "--pin")
+		{
+			options.pin = true;
+		}
+		else if (option == "--hardware")
+		{
+			options.hardware = true;
+		}
+		else if (value == NULL)
+		{
+			fprintf(stderr, "unknown option or missing value: %s\n", option.c_str());
+			return false;
+		}
+		else
+		{
+			i++;
+
+			if (option == "--module")
+			{
+				options.modules = splitList(value);
+			}
+			else if (option == "--benchmark")
+			{
+				options.benchmarks = splitList(value);
+			}
+			else if (option == "--sizes")
+			{
+				options.customSizes = true;
+				if (sscanf(value, "%lld:%lld:%lld", &options.first, &options.last, &options.step) != 3 || options.step <= 0 || options.first > options.last)
+				{
+					fprintf(stderr, "bad size range: %s\n", value);
+					return false;
+				}
+			}
+			else if (option == "--threads")
+			{
+				options.threads = atoi(value);
+			}
+			else if (option == "--seed")
+			{
+				options.customSeed = true;
+				options.seed = strtoull(value, NULL, 10);
+			}
+			else if (option == "--format")
+			{
+				options.formats = parseFormats(value);
+				if (options.formats == 0)
+				{
+					fprintf(stderr, "bad format list: %s\n", value);
+					return false;
+				}
+			}
+			else if (option == "--output")
+			{
+				options.output = value;
+			}
+			else
+			{
+				fprintf(stderr, "unknown option: %s\n", option.c_str());
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+* runs the selected benchmarks of one module into a profiler of its own and writes its report
+*/
+int runModule(const std::string& module, const std::vector<Benchmark*>& benchmarks, const Options& options) {
+	Profiler profiler(module.c_str());
+	std::string reportName = options.output + module;
+	bool failed = false;
+
+	profiler.setReportOutput(options.formats, options.output.empty() ? NULL : reportName.c_str());
+	if (options.hardware && !profiler.enableHardwareCounters())
+	{
+		fprintf(stderr, "hardware counters are not available\n");
+	}
+
+	for (size_t i = 0; i < benchmarks.size(); i++)
+	{
+		Benchmark* benchmark = benchmarks[i];
+
+		printf("%s: %s\n", module.c_str(), benchmark->name().c_str());
+		fflush(stdout);
+
+		SetRandomSeed(options.seed);
+		try
+		{
+			if (options.customSizes && benchmark->sizeAxis() == "elements")
+			{
+				benchmark->run(profiler, options.first, options.last, options.step);
+			}
+			else
+			{
+				if (options.customSizes)
+				{
+					printf("%s: %s keeps its sizes, they are not element counts (%s)\n", module.c_str(), benchmark->name().c_str(), benchmark->sizeAxis().c_str());
+				}
+				benchmark->run(profiler, benchmark->firstSize(), benchmark->lastSize(), benchmark->sizeStep());
+			}
+		}
+		catch (const char* error)
+		{
+			fprintf(stderr, "%s: %s failed: %s\n", module.c_str(), benchmark->name().c_str(), error);
+			failed = true;
+		}
+		catch (const std::exception& error)
+		{
+			fprintf(stderr, "%s: %s failed: %s\n", module.c_str(), benchmark->name().c_str(), error.what());
+			failed = true;
+		}
+	}
+
+	return profiler.showReport() != 0 || failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	std::vector<Benchmark*>& registry = Benchmark::registry();
+	std::vector<std::string> modules;
+	int result = 0;
+
+	if (!parseOptions(argc, argv, options))
+	{
+		printUsage();
+		return 2;
+	}
+
+	for (size_t i = 0; i < registry.size(); i++)
+	{
+		if (std::find(modules.begin(), modules.end(), registry[i]->module()) == modules.end())
+		{
+			modules.push_back(registry[i]->module());
+		}
+	}
+
+	if (options.list)
+	{
+		for (size_t m = 0; m < modules.size(); m++)
+		{
+			printf("%s\n", modules[m].c_str());
+			for (size_t i = 0; i < registry.size(); i++)
+			{
+				if (registry[i]->module() == modules[m])
+				{
+					printf("\t%s (sizes %lld:%lld:%lld", registry[i]->name().c_str(),
+						registry[i]->firstSize(), registry[i]->lastSize(), registry[i]->sizeStep());
+					if (registry[i]->sizeAxis() != "elements")
+					{
+						printf(", %s", registry[i]->sizeAxis().c_str());
+					}
+					printf(")\n");
+				}
+			}
+		}
+
+		return 0;
+	}
+
+	for (size_t n = 0; n < options.modules.size(); n++)
+	{
+		bool found = false;
+
+		for (size_t m = 0; m < modules.size(); m++)
+		{
+			found = found || Benchmark::matches(modules[m], options.modules[n].c_str());
+		}
+
+		if (!found)
+		{
+			fprintf(stderr, "no module named %s, see --list\n", options.modules[n].c_str());
+			return 2;
+		}
+	}
+
+	for (size_t n = 0; n < options.benchmarks.size(); n++)
+	{
+		bool found = false;
+
+		for (size_t i = 0; i < registry.size(); i++)
+		{
+			found = found || (selected(options.modules, registry[i]->module()) && Benchmark::matches(registry[i]->name(), options.benchmarks[n].c_str()));
+		}
+
+		if (!found)
+		{
+			fprintf(stderr, "no benchmark named %s in the selected modules, see --list\n", options.benchmarks[n].c_str());
+			return 2;
+		}
+	}
+
+	SetSweepThreads(options.threads);
+	SetSweepPinning(options.pin);
+	if (!options.customSeed)
+	{
+		options.seed = GetRandomSeed();
+	}
+
+	for (size_t m = 0; m < modules.size(); m++)
+	{
+		std::vector<Benchmark*> benchmarks;
+
+		if (!selected(options.modules, modules[m]))
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < registry.size(); i++)
+		{
+			if (registry[i]->module() == modules[m] && selected(options.benchmarks, registry[i]->name()))
+			{
+				benchmarks.push_back(registry[i]);
+			}
+		}
+
+		if (!benchmarks.empty() && runModule(modules[m], benchmarks, options) != 0)
+		{
+			result = 1;
+		}
+	}
+
+	return result;
+}
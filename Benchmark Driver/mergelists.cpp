@@ -0,0 +1,68 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace MergeLists {
+#include "../Merge K Sroted Lists/main.cpp"
+#include "../Merge K Sroted Lists/lists.cpp"
+
+/**
+* k sorted lists, filled from one array of n keys
+*/
+struct SortedLists {
+	ListH** lists;
+	int k;
+};
+
+SortedLists makeLists(int k, int n) {
+	SortedLists input;
+
+	input.lists = createLists(k, n);
+	input.k = k;
+
+	return input;
+}
+
+void merge(SortedLists& input, int) {
+	ListH* L = createList();
+
+	mergeLists<CountingPolicy>(input.lists, input.k, L, false);
+	freeList(L);
+}
+
+void setBounds() {
+	LEFT = 10;
+	RIGHT = 50000;
+}
+
+bool registerBenchmarks() {
+	int fixedK[] = { 5, 10, 100 };
+	BenchmarkOf<SortedLists>& varyN = RegisterBenchmark<SortedLists>("Merge K Sorted Lists", "Vary n");
+
+	for (int i = 0; i < 3; i++)
+	{
+		int k = fixedK[i];
+		varyN.input("k = " + std::to_string(k), [k](int n) { return makeLists(k, n); });
+	}
+
+	varyN.sizes(100, 9900, 100)
+		.setup(setBounds)
+		.release([](SortedLists& input, int) { freeArrayList(input.lists, input.k); })
+		.reset([]() { OP = 0; })
+		.algorithm("Merge", merge)
+		.metric("operations", []() { return (double)OP; });
+
+	RegisterBenchmark<SortedLists>("Merge K Sorted Lists", "Vary k")
+		.sizes(10, 490, 10)
+		.setup(setBounds)
+		.input("n = 10000", [](int k) { return makeLists(k, 10000); })
+		.release([](SortedLists& input, int) { freeArrayList(input.lists, input.k); })
+		.reset([]() { OP = 0; })
+		.algorithm("Merge", merge)
+		.metric("operations", []() { return (double)OP; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
@@ -0,0 +1,39 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace OrderStatisticTree {
+#include "../Order Statistic Tree/main.cpp"
+
+bool registerBenchmarks() {
+	RegisterBenchmark<Tree*>("Order Statistic Tree", "Select & Delete")
+		.sizes(100, 10000, 100)
+		.setup([]() { MIN = 10; MAX = 50000; })
+		.input("balanced", [](int size) { return buildTree<CountingPolicy>(size); })
+		.release([](Tree*& T, int) { freeTree(T); })
+		.reset([]() { OS_S_OP_T = OS_D_OP_T = BUILD_OP = 0; })
+		.algorithm("random order", [](Tree*& T, int) {
+			for (int i = 0; i < T->size; i++)
+			{
+				OS_S_OP = 0;
+				OS_D_OP = 0;
+
+				int index = 1 + (int)RandomEngine().nextBelow(T->size);
+
+				OS_Select<CountingPolicy>(T->root, index);
+				OS_S_OP_T += OS_S_OP;
+				OS_D_OP_T += OS_S_OP;
+
+				OS_Delete<CountingPolicy>(T, index);
+				OS_D_OP_T += OS_D_OP;
+			}
+		})
+		.metric("OS_Select", []() { return (double)OS_S_OP_T; })
+		.metric("OS_Delete", []() { return (double)OS_D_OP_T; })
+		.metric("build", []() { return (double)BUILD_OP; });
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
@@ -0,0 +1,50 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace QuickSort {
+#include "../Quick Sort/main.cpp"
+
+bool registerBenchmarks() {
+	BenchmarkOf<int*>& sort = RegisterSortBenchmark("Quick Sort", "Heap & Quick")
+		.sizes(100, 9900, 100)
+		.reset(initOp)
+		.algorithm("HeapSort", [](int*& a, int size) { heapSort<CountingPolicy>(a, size); },
+			[](int*& a, int size) { heapSort<NullPolicy>(a, size); })
+		.metric("operations", []() { return (double)(HS_OP + QS_OP); });
+
+	for (int mode = QS_CLASSIC; mode < QS_MODE_COUNT; mode++)
+	{
+		sort.algorithm(QuickSortModeName(mode), [mode](int*& a, int size) { quickSortMode<CountingPolicy>(a, size, mode); },
+			[mode](int*& a, int size) { quickSortMode<NullPolicy>(a, size, mode); });
+	}
+
+	// few distinct keys, where the 3-way and the dual pivot modes pay off
+	BenchmarkOf<int*>& duplicates = RegisterSortBenchmark("Quick Sort", "Duplicate Keys", DUPLICATES_MIN, DUPLICATES_MAX)
+		.sizes(100, 9900, 100)
+		.reset(initOp)
+		.metric("operations", []() { return (double)(HS_OP + QS_OP); });
+
+	for (int mode = QS_CLASSIC; mode < QS_MODE_COUNT; mode++)
+	{
+		duplicates.algorithm(QuickSortModeName(mode), [mode](int*& a, int size) { quickSortMode<CountingPolicy>(a, size, mode); },
+			[mode](int*& a, int size) { quickSortMode<NullPolicy>(a, size, mode); });
+	}
+
+	BenchmarkOf<int*>& pivots = RegisterSortBenchmark("Quick Sort", "Pivot Strategies")
+		.sizes(100, 9900, 100)
+		.reset(initOp)
+		.metric("operations", []() { return (double)QS_OP; });
+
+	for (int strategy = PIVOT_LAST; strategy < PIVOT_STRATEGY_COUNT; strategy++)
+	{
+		pivots.algorithm(std::string("QuickSort ") + PivotStrategyName(strategy) + " pivot",
+			[strategy](int*& a, int size) { quickSort<CountingPolicy>(a, 0, size - 1, false, strategy); },
+			[strategy](int*& a, int size) { quickSort<NullPolicy>(a, 0, size - 1, false, strategy); });
+	}
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
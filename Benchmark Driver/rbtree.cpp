@@ -0,0 +1,61 @@
+#include "../Profiler/Benchmark.h"
+
+#define BENCHMARK_DRIVER
+
+namespace RedBlackTree {
+#include "../RB Tree/main.cpp"
+
+/**
+* a tree of unique keys and its nodes in the order they are deleted
+*/
+struct FilledTree {
+	RBTree* T;
+	NodeRB** nodes;
+};
+
+bool registerBenchmarks() {
+	RegisterBenchmark<FilledTree>("RB Tree", "Delete")
+		.sizes(1000, 10000, 1000)
+		.input("random order", [](int size) {
+			FilledTree input;
+			int* a = (int*)malloc(size * sizeof(int));
+			int* index = (int*)malloc(size * sizeof(int));
+
+			FillRandomArray(a, size, 1, 10 * size, true, 0);
+			FillRandomArray(index, size, 0, size - 1, true, 0);
+
+			input.T = createTree();
+			input.nodes = (NodeRB**)malloc(size * sizeof(NodeRB*));
+
+			for (int i = 0; i < size; i++)
+			{
+				RbInsert(input.T, a[i]);
+			}
+
+			for (int i = 0; i < size; i++)
+			{
+				input.nodes[i] = searchKey(input.T, a[index[i]]);
+			}
+
+			free(index);
+			free(a);
+
+			return input;
+		})
+		.release([](FilledTree& input, int) {
+			free(input.T->null);
+			free(input.T);
+			free(input.nodes);
+		})
+		.algorithm("RBDelete", BenchmarkOf<FilledTree>::Algorithm(), [](FilledTree& input, int size) {
+			for (int i = 0; i < size; i++)
+			{
+				RBDelete(input.T, input.nodes[i]);
+			}
+		});
+
+	return true;
+}
+
+bool registered = registerBenchmarks();
+}
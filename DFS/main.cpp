@@ -2,12 +2,15 @@
 #include<stdlib.h>
 #include <stack> 
 #include <algorithm>  
-#include "Profiler.h"
+#define PROFILER_TRACK_ALLOCATIONS
+#include "../Profiler/Profiler.h"
 
 using namespace std;
 
 #define VARRY_E "Computational Effort Varry E"
 #define VARRY_V "Computational Effort Varry V"
+#define MEMORY_E "Memory Varry E"
+#define MEMORY_V "Memory Varry V"
 
 Profiler profiler("DFS");
 
@@ -42,9 +45,9 @@ Profiler profiler("DFS");
 */
 
 enum Color { Black = 0, White = 1, Grey = 2 };
-int OP;
-int TIME;
-int ID;
+thread_local unsigned long long OP;
+thread_local int TIME;
+thread_local int ID;
 
 typedef struct nodeL {
 	struct nodeG* key;
@@ -146,8 +149,9 @@ bool checkForEdge(NodeG* nodeA, NodeG* nodeB) {
 }
 
 NodeG** createGraph(int V, int E) {
-	srand(time(0));
 	NodeG** nodes = (NodeG**)malloc(V * sizeof(NodeG*));
+	int* ends = (int*)malloc(2 * E * sizeof(int)); // candidate edges, generated in parallel
+	int used = 2 * E;
 
 	for (int i = 0; i < V; i++)
 	{
@@ -157,8 +161,14 @@ NodeG** createGraph(int V, int E) {
 	int nbOfEdges = 0;
 	while (nbOfEdges < E)
 	{
-		int indexA = rand() % V;
-		int indexB = rand() % V;
+		if (used == 2 * E)
+		{
+			FillRandomArray(ends, 2 * E, 0, V - 1);
+			used = 0;
+		}
+
+		int indexA = ends[used++];
+		int indexB = ends[used++];
 
 		if (indexA != indexB && !checkForEdge(nodes[indexA], nodes[indexB]))
 		{
@@ -168,6 +178,8 @@ NodeG** createGraph(int V, int E) {
 		}
 	}
 
+	free(ends);
+
 	return nodes;
 }
 
@@ -224,6 +236,7 @@ void printByTime(NodeDFS* nodesDFS, int size) {
 	}
 }
 
+template <typename Count>
 void DFS_Visit(NodeDFS* nodesDFS, int node, std::stack <int> *ordered)
 {
 	TIME++;
@@ -235,10 +248,10 @@ void DFS_Visit(NodeDFS* nodesDFS, int node, std::stack <int> *ordered)
 	while (curr) {
 		if (nodesDFS[curr->key->key - 1].color == White) {
 			nodesDFS[curr->key->key - 1].parent = node;
-			OP++;
-			DFS_Visit(nodesDFS, curr->key->key - 1, ordered);
+			Count::add(OP);
+			DFS_Visit<Count>(nodesDFS, curr->key->key - 1, ordered);
 		}
-		OP++;
+		Count::add(OP);
 
 		curr = curr->next;
 	}
@@ -250,6 +263,7 @@ void DFS_Visit(NodeDFS* nodesDFS, int node, std::stack <int> *ordered)
 	(*ordered).push(nodesDFS[node].node->key);
 }
 
+template <typename Count>
 void DFS(NodeG** nodes, int V, bool demo, bool sort) {
 
 	NodeDFS* nodesDFS = (NodeDFS*)malloc(V * sizeof(NodeDFS));
@@ -264,7 +278,7 @@ void DFS(NodeG** nodes, int V, bool demo, bool sort) {
 		nodesDFS[i].timeFin = 0;
 		nodesDFS[i].parent = -1;
 
-		OP++;
+		Count::add(OP);
 	}
 
 	TIME = 0;
@@ -273,9 +287,9 @@ void DFS(NodeG** nodes, int V, bool demo, bool sort) {
 	{
 		if (nodesDFS[i].color == White)
 		{
-			DFS_Visit(nodesDFS, i, &ordered);
+			DFS_Visit<Count>(nodesDFS, i, &ordered);
 		}
-		OP++;
+		Count::add(OP);
 	}
 
 	if (demo) {
@@ -389,7 +403,7 @@ void demoDFS() {
 	printf("\n\n");
 
 	TIME = 0;
-	DFS(nodes, V, true, false);
+	DFS<NullPolicy>(nodes, V, true, false);
 	printf("\n\n");
 
 	printf("----------------------------------------DEMO END----------------------------------------------\n\n");
@@ -407,7 +421,7 @@ void demoTS() {
 	printf("\n\n");
 
 	TIME = 0;
-	DFS(nodes, V, false, true);
+	DFS<NullPolicy>(nodes, V, false, true);
 	printf("\n\n");
 
 	printf("----------------------------------------DEMO END----------------------------------------------\n\n");
@@ -452,42 +466,44 @@ void demoTarjan() {
 
 void generateChartVarryE() {
 	int V = 100;
-	int E;
-	NodeG** nodes;
 
-	for (E = 1000; E <= 5000; E += 100)
-	{
+	ParallelSweep(1000, 5000, 100, [&](int E) {
+		NodeG** nodes;
+
 		OP = 0;
 
+		profiler.startAllocations(MEMORY_E, E);
 		nodes = createGraph(V, E);
 
 		TIME = 0;
-		DFS(nodes, V, false, false);
+		DFS<CountingPolicy>(nodes, V, false, false);
+		profiler.stopAllocations(MEMORY_E, E);
 
 		freeGraph(nodes, V);
 
 		profiler.countOperation(VARRY_E, E, OP);
-	}
+	});
 }
 
 void generateChartVarryV() {
-	int V;
 	int E = 9000;
-	NodeG** nodes;
 
-	for (V = 100; V <= 200; V += 10)
-	{
+	ParallelSweep(100, 200, 10, [&](int V) {
+		NodeG** nodes;
+
 		OP = 0;
 
+		profiler.startAllocations(MEMORY_V, V);
 		nodes = createGraph(V, E);
 
 		TIME = 0;
-		DFS(nodes, V, false, false);
+		DFS<CountingPolicy>(nodes, V, false, false);
+		profiler.stopAllocations(MEMORY_V, V);
 
 		freeGraph(nodes, V);
 
 		profiler.countOperation(VARRY_V, V, OP);
-	}
+	});
 }
 
 void generateCharts() {
@@ -495,10 +511,14 @@ void generateCharts() {
 
 	generateChartVarryV();
 
+	profiler.createGroup("Graph Memory Varry E", MEMORY_E " bytes", MEMORY_E " peak bytes");
+	profiler.createGroup("Graph Memory Varry V", MEMORY_V " bytes", MEMORY_V " peak bytes");
+
 	profiler.showReport();
 }
 
-void main() {
+#ifndef BENCHMARK_DRIVER
+int main() {
 
 	demoDFS();
 	demoTS();
@@ -506,4 +526,7 @@ void main() {
 
 
 	generateCharts();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
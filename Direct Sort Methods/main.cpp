@@ -1,8 +1,10 @@
 #include <iostream>
+#ifdef _MSC_VER
 #include <conio.h>	
+#endif
 #include <stdio.h>	
 
-#include "Profiler.h"	
+#include "../Profiler/Profiler.h"	
 
 using namespace std;
 
@@ -123,26 +125,12 @@ Profiler profiler("Demo");
 #define WORST_SEL_C "Worst SelectionSort Comparisons"
 #define WORST_SEL "Worst SelectionSort"
 
-int BUB_A, BUB_C, INS_A, INS_C, SEL_A, SEL_C;			
-int T_BUB_A, T_BUB_C, T_INS_A, T_INS_C, T_SEL_A, T_SEL_C;	//used to compute the average case
+thread_local unsigned long long BUB_A, BUB_C, INS_A, INS_C, SEL_A, SEL_C;			
 
 void initAssigComp() {
 	BUB_A = BUB_C = INS_A = INS_C = SEL_A = SEL_C = 0;
 }
 
-void initTotalAssigComp() {
-	T_BUB_A = T_BUB_C = T_INS_A = T_INS_C = T_SEL_A = T_SEL_C = 0;
-}
-
-void addAssigComp() {
-	T_BUB_A += BUB_A;
-	T_BUB_C += BUB_C;
-	T_INS_A += INS_A;
-	T_INS_C += INS_C;
-	T_SEL_A += SEL_A;
-	T_SEL_C += SEL_C;
-}
-
 int* generateCopyArray(int* src, int size) {
 	int* copy = (int*)malloc(size * sizeof(int));
 
@@ -178,6 +166,7 @@ void swap(int* a, int* b) {
 	*b = aux;
 }
 
+template <typename Count>
 void bubbleSort(int* a, int n) {
 
 	for (int i = 0; i < n - 1; i++)
@@ -190,10 +179,10 @@ void bubbleSort(int* a, int n) {
 			{
 				swap(&a[j], &a[j + 1]);
 				//swapped = true;
-				BUB_A += 3;
+				Count::add(BUB_A, 3);
 			}
 
-			BUB_C++;
+			Count::add(BUB_C);
 		}
 
 	//	if (!swapped) {
@@ -202,6 +191,7 @@ void bubbleSort(int* a, int n) {
 	}
 }
 
+template <typename Count>
 void insertionSort(int* a, int n) {
 	int buf;
 	int j;
@@ -210,21 +200,22 @@ void insertionSort(int* a, int n) {
 	{
 		j = i - 1;
 		buf = a[i];
-		INS_A++;
+		Count::add(INS_A);
 
 		while (j >= 0 && a[j] > buf)
 		{
-			INS_C++;
+			Count::add(INS_C);
 			a[j + 1] = a[j];
-			INS_A++;
+			Count::add(INS_A);
 			j--;
 		}
 
 		a[j + 1] = buf;
-		INS_A++;
+		Count::add(INS_A);
 	}
 }
 
+template <typename Count>
 void selectionSort(int* a, int n) {
 	int index;
 
@@ -236,11 +227,11 @@ void selectionSort(int* a, int n) {
 		{
 			if (a[index] > a[j])
 				index = j;
-			SEL_C++;
+			Count::add(SEL_C);
 		}
 
 		swap(&a[i], &a[index]);
-		SEL_A += 3;
+		Count::add(SEL_A, 3);
 	}
 }
 
@@ -250,7 +241,7 @@ void demoBubble() {
 	int a[5] = { 3,7,11,2,12 };
 
 	printArray(a, 5);
-	bubbleSort(a, 5);
+	bubbleSort<NullPolicy>(a, 5);
 	printArray(a, 5);
 }
 
@@ -260,7 +251,7 @@ void demoInsertion() {
 	int a[5] = { 3,7,11,2,1 };
 
 	printArray(a, 5);
-	insertionSort(a, 5);
+	insertionSort<NullPolicy>(a, 5);
 	printArray(a, 5);
 }
 
@@ -270,47 +261,42 @@ void demoSelection() {
 	int a[5] = { 3,7,11,2,1 };
 
 	printArray(a, 5);
-	selectionSort(a, 5);
+	selectionSort<NullPolicy>(a, 5);
 	printArray(a, 5);
 }
 
 void createChartAverage() {
-	int* array;
-	int* sample;
-
-	for (int size = 100; size <= 10000; size += 100)
-	{
-		initTotalAssigComp();
+	ParallelSweep(100, 10000, 100, [](int size) {
+		int* array;
+		int* sample;
 
-		for (int i = 0; i < 5; i++)
+		for (BenchmarkRunner run(profiler, size); run.next(); )
 		{
 			sample = generateArray(size, 0);
 			initAssigComp();
 
 			array = generateCopyArray(sample, size);
-			bubbleSort(array, size);
+			bubbleSort<CountingPolicy>(array, size);
 			free(array);
 
 			array = generateCopyArray(sample, size);
-			insertionSort(array, size);
+			insertionSort<CountingPolicy>(array, size);
 			free(array);
 
 			array = generateCopyArray(sample, size);
-			selectionSort(array, size);
+			selectionSort<CountingPolicy>(array, size);
 			free(array);
 
-			addAssigComp();
-
 			free(sample);
-		}
 
-		profiler.countOperation(AVG_BUB_A, size, T_BUB_A / 5);
-		profiler.countOperation(AVG_BUB_C, size, T_BUB_C / 5);
-		profiler.countOperation(AVG_INS_A, size, T_INS_A / 5);
-		profiler.countOperation(AVG_INS_C, size, T_INS_C / 5);
-		profiler.countOperation(AVG_SEL_A, size, T_SEL_A / 5);
-		profiler.countOperation(AVG_SEL_C, size, T_SEL_C / 5);
-	}
+			run.record(AVG_BUB_A, BUB_A);
+			run.record(AVG_BUB_C, BUB_C);
+			run.record(AVG_INS_A, INS_A);
+			run.record(AVG_INS_C, INS_C);
+			run.record(AVG_SEL_A, SEL_A);
+			run.record(AVG_SEL_C, SEL_C);
+		}
+	});
 
 	profiler.addSeries(AVG_BUB, AVG_BUB_A, AVG_BUB_C);
 	profiler.addSeries(AVG_INS, AVG_INS_A, AVG_INS_C);
@@ -318,16 +304,15 @@ void createChartAverage() {
 }
 
 void createChartBest() {
-	int* sample;
+	ParallelSweep(100, 10000, 100, [](int size) {
+		int* sample;
 
-	for (int size = 100; size <= 10000; size += 100)
-	{
 		sample = generateArray(size, 1);
 		initAssigComp();
 
-		bubbleSort(sample, size);
-		insertionSort(sample, size);
-		selectionSort(sample, size);
+		bubbleSort<CountingPolicy>(sample, size);
+		insertionSort<CountingPolicy>(sample, size);
+		selectionSort<CountingPolicy>(sample, size);
 
 		free(sample);
 
@@ -337,7 +322,7 @@ void createChartBest() {
 		profiler.countOperation(BEST_INS_C, size, INS_C);
 		profiler.countOperation(BEST_SEL_A, size, SEL_A);
 		profiler.countOperation(BEST_SEL_C, size, SEL_C);
-	}
+	});
 
 	profiler.addSeries(BEST_BUB, BEST_BUB_A, BEST_BUB_C);
 	profiler.addSeries(BEST_INS, BEST_INS_A, BEST_INS_C);
@@ -345,28 +330,25 @@ void createChartBest() {
 }
 
 void createChartWorst() {
-	int* array;
-	int* sample;
+	ParallelSweep(100, 10000, 100, [](int size) {
+		int* array;
+		int* sample;
 
-	for (int size = 100; size <= 10000; size += 100)
-	{
 			sample = generateArray(size, 2);
 			initAssigComp();
 
 			array = generateCopyArray(sample, size);
-			bubbleSort(array, size);
+			bubbleSort<CountingPolicy>(array, size);
 			free(array);
 
 			array = generateCopyArray(sample, size);
-			insertionSort(array, size);
+			insertionSort<CountingPolicy>(array, size);
 			free(array);
 
 			array = generateCopyArray(sample, size);
-			selectionSort(array, size);
+			selectionSort<CountingPolicy>(array, size);
 			free(array);
 
-			addAssigComp(); // adds the assig and comp to the total assg and comp 
-
 			free(sample);
 
 			profiler.countOperation(WORST_BUB_A, size, BUB_A);
@@ -375,13 +357,51 @@ void createChartWorst() {
 			profiler.countOperation(WORST_INS_C, size, INS_C);
 			profiler.countOperation(WORST_SEL_A, size, SEL_A);
 			profiler.countOperation(WORST_SEL_C, size, SEL_C);
-	}
+	});
 
 	profiler.addSeries(WORST_BUB, WORST_BUB_A, WORST_BUB_C);
 	profiler.addSeries(WORST_INS, WORST_INS_A, WORST_INS_C);
 	profiler.addSeries(WORST_SEL, WORST_SEL_A, WORST_SEL_C);
 }
 
+void createChartDistributions() {
+	for (int method = NEARLY_SORTED; method < SORT_METHOD_COUNT; method++)
+	{
+		string bubbleName = string("Bubble Sort ") + SortMethodName(method);
+		string insertionName = string("Insertion Sort ") + SortMethodName(method);
+		string selectionName = string("Selection Sort ") + SortMethodName(method);
+
+		ParallelSweep(500, 10000, 500, [&](int size) {
+			int* array;
+			int* sample;
+
+			sample = generateArray(size, method);
+			initAssigComp();
+
+			array = generateCopyArray(sample, size);
+			bubbleSort<CountingPolicy>(array, size);
+			free(array);
+
+			array = generateCopyArray(sample, size);
+			insertionSort<CountingPolicy>(array, size);
+			free(array);
+
+			array = generateCopyArray(sample, size);
+			selectionSort<CountingPolicy>(array, size);
+			free(array);
+
+			free(sample);
+
+			profiler.countOperation(bubbleName.c_str(), size, BUB_A + BUB_C);
+			profiler.countOperation(insertionName.c_str(), size, INS_A + INS_C);
+			profiler.countOperation(selectionName.c_str(), size, SEL_A + SEL_C);
+		});
+
+		profiler.createGroup((string("Operations ") + SortMethodName(method)).c_str(),
+			bubbleName.c_str(), selectionName.c_str(), insertionName.c_str());
+	}
+}
+
 void createCharts() {
 	
 	createChartAverage();
@@ -399,8 +419,11 @@ void createCharts() {
 	profiler.createGroup("Worst Case Operations", WORST_BUB, WORST_SEL, WORST_INS);
 	profiler.createGroup("Worst Case Assignments", WORST_BUB_A, WORST_SEL_A, WORST_INS_A);
 	profiler.createGroup("Worst Case Comparisons", WORST_BUB_C, WORST_SEL_C, WORST_INS_C);
+
+	createChartDistributions();
 }
 
+#ifndef BENCHMARK_DRIVER
 int main() {
 	demoBubble();
 	demoInsertion();
@@ -411,8 +434,8 @@ int main() {
 	//createChartWorst();
 
 	createCharts();
-
 	profiler.showReport();
 
-	return 0;
-}
\ No newline at end of file
+	return profiler.hasRegressions() ? 1 : 0;
+}
+#endif
\ No newline at end of file
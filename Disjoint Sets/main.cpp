@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include "Profiler.h"
+#define PROFILER_TRACK_ALLOCATIONS
+#include "../Profiler/Profiler.h"
 
 #define COMP_EFF "Computational Effort Of Set Operations"
+#define SETS_MEMORY "Memory Of Disjoint Sets"
+#define FIND_SET_COST "Operations Per FindSet"
 
 Profiler profiler("Disjoint Sets And Kruskal Algorithm");
 
@@ -46,7 +49,7 @@ Profiler profiler("Disjoint Sets And Kruskal Algorithm");
 =============================================================================================================================================================
 */
 
-int OP;
+thread_local unsigned long long OP;
 int maxWeight;
 
 typedef struct node {
@@ -61,6 +64,7 @@ typedef struct edge {
 	struct node* dest;
 } Edge;
 
+template <typename Count>
 Node* createNode(int key) {
 	Node* node = (Node*)malloc(sizeof(Node));
 
@@ -70,13 +74,14 @@ Node* createNode(int key) {
 		node->maxHeight = 0;
 		node->parent = node;
 
-		OP += 3;
+		Count::add(OP, 3);
 		return node;
 	}
 
 	return NULL;
 }
 
+template <typename Count>
 Node** createDisjointSets(int size) {
 	Node** disjointSets = (Node**)malloc(size * sizeof(Node*));
 
@@ -84,7 +89,7 @@ Node** createDisjointSets(int size) {
 	{
 		for (int i = 0; i < size; i++)
 		{
-			disjointSets[i] = createNode(i + 1);
+			disjointSets[i] = createNode<Count>(i + 1);
 		}
 
 		return disjointSets;
@@ -94,9 +99,9 @@ Node** createDisjointSets(int size) {
 }
 
 int** createAdjacencyMatrix(int size) {
-	srand(time(0));
-
-	int weight;
+	int* weights = (int*)malloc(4 * size * sizeof(int));
+	int* ends = (int*)malloc(8 * size * sizeof(int)); // candidate edges, generated in parallel
+	int used = 4 * size;
 	int** adjMatrix = (int**)malloc(size * sizeof(int*));
 
 	for (int i = 0; i < size; i++)
@@ -106,12 +111,12 @@ int** createAdjacencyMatrix(int size) {
 
 	int* edges = (int*)malloc(size * sizeof(int));
 	FillRandomArray(edges, size, 0, size - 1, true, 0);
+	FillRandomArray(weights, size - 1, 1, maxWeight);
 
 	for (int i = 0; i < size - 1; i++)
 	{
-		weight = 1 + rand() % maxWeight;
-		adjMatrix[edges[i]][edges[i + 1]] = weight;
-		adjMatrix[edges[i + 1]][edges[i]] = weight;
+		adjMatrix[edges[i]][edges[i + 1]] = weights[i];
+		adjMatrix[edges[i + 1]][edges[i]] = weights[i];
 	}
 
 	int edgesLeftToAdd = 4 * size - (size - 1);
@@ -119,18 +124,29 @@ int** createAdjacencyMatrix(int size) {
 
 	while (edgesLeftToAdd > 0)
 	{
-		src = rand() % size;
-		dest = rand() % size;
+		if (used == 4 * size)
+		{
+			FillRandomArray(ends, 8 * size, 0, size - 1);
+			FillRandomArray(weights, 4 * size, 1, maxWeight);
+			used = 0;
+		}
+
+		src = ends[2 * used];
+		dest = ends[2 * used + 1];
 
 		if (adjMatrix[src][dest] == 0 && src != dest)
 		{
-			weight = 1 + rand() % maxWeight;
-			adjMatrix[src][dest] = weight;
-			adjMatrix[dest][src] = weight;
+			adjMatrix[src][dest] = weights[used];
+			adjMatrix[dest][src] = weights[used];
 			edgesLeftToAdd--;
 		}
+		used++;
 	}
 
+	free(ends);
+	free(weights);
+	free(edges);
+
 	return adjMatrix;
 }
 
@@ -161,8 +177,7 @@ int partition(Edge* a, int l, int r) {
 }
 
 int randomPartition(Edge* a, int l, int r) {
-	srand(time(0));
-	int random = l + rand() % (r - l + 1);
+	int random = l + (int)RandomEngine().nextBelow(r - l + 1);
 
 	swap(&a[r], &a[random]);
 
@@ -223,17 +238,19 @@ void freeMatrix(int** matrix, int size) {
 	free(matrix);
 }
 
+template <typename Count>
 Node* findSet(Node* node) {
 	if (node != node->parent)
 	{
-		node->parent = findSet(node->parent);
-		OP++;
+		node->parent = findSet<Count>(node->parent);
+		Count::add(OP);
 	}
 
-	OP++;
+	Count::add(OP);
 	return node->parent;
 }
 
+template <typename Count>
 void combineSets(Node* setA, Node* setB) {
 
 	if (setA->maxHeight > setB->maxHeight)
@@ -243,7 +260,7 @@ void combineSets(Node* setA, Node* setB) {
 
 		setB = setA;
 
-		OP += 3;
+		Count::add(OP, 3);
 	}
 	else
 	{
@@ -252,16 +269,16 @@ void combineSets(Node* setA, Node* setB) {
 
 		setA = setB;
 
-		OP += 3;
+		Count::add(OP, 3);
 	}
 
-	OP++;
+	Count::add(OP);
 }
 
 void printDisjointSets(Node** sets, int size) {
 	for (int i = 0; i < size; i++)
 	{
-		printf("Set %d representative is %d\n", i + 1, findSet(sets[i])->key);
+		printf("Set %d representative is %d\n", i + 1, findSet<NullPolicy>(sets[i])->key);
 	}
 
 	printf("\n");
@@ -287,11 +304,11 @@ void printEdges(Edge* edges, int size) {
 }
 
 bool isOneSet(Node** disjointSets, int size) {
-	Node* representant = findSet(disjointSets[0]);
+	Node* representant = findSet<NullPolicy>(disjointSets[0]);
 
 	for (int i = 1; i < size; i++)
 	{
-		if (representant != findSet(disjointSets[i]))
+		if (representant != findSet<NullPolicy>(disjointSets[i]))
 		{
 			return false;
 		}
@@ -304,7 +321,7 @@ void demoDisjointSets() {
 	srand(time(0));
 	int size = 10;
 
-	Node** disjointSets = createDisjointSets(size);
+	Node** disjointSets = createDisjointSets<NullPolicy>(size);
 
 	printf("\t\t\t\t\t DEMO DISJOINT SETS\n\n");
 	printf("\t\t Sets After Creation\n");
@@ -319,11 +336,11 @@ void demoDisjointSets() {
 		indexA = rand() % size;
 		indexB = rand() % size;
 
-		if (findSet(disjointSets[indexA]) != findSet(disjointSets[indexB]))
+		if (findSet<NullPolicy>(disjointSets[indexA]) != findSet<NullPolicy>(disjointSets[indexB]))
 		{
 			printf("\t\t Union Between Sets %d And %d\n", disjointSets[indexA]->key, disjointSets[indexB]->key);
 
-			combineSets(findSet(disjointSets[indexA]), findSet(disjointSets[indexB]));
+			combineSets<NullPolicy>(findSet<NullPolicy>(disjointSets[indexA]), findSet<NullPolicy>(disjointSets[indexB]));
 
 			printDisjointSets(disjointSets, size);
 
@@ -341,7 +358,7 @@ void demoKruskal() {
 	maxWeight = 50;
 	int size = 10;
 
-	Node** disjointSets = createDisjointSets(size);
+	Node** disjointSets = createDisjointSets<NullPolicy>(size);
 
 	int** adjMatrix = createAdjacencyMatrix(size);
 	printf("\n\t\t GRAPH BY ADJANCENCY MATRIX\n\n");
@@ -358,9 +375,9 @@ void demoKruskal() {
 
 	while (!isOneSet(disjointSets, size))
 	{
-		if (findSet(edges[indexEdges].src) != findSet(edges[indexEdges].dest))
+		if (findSet<NullPolicy>(edges[indexEdges].src) != findSet<NullPolicy>(edges[indexEdges].dest))
 		{
-			combineSets(findSet(edges[indexEdges].src), findSet(edges[indexEdges].dest));
+			combineSets<NullPolicy>(findSet<NullPolicy>(edges[indexEdges].src), findSet<NullPolicy>(edges[indexEdges].dest));
 			selectedEdges[indexSelEdges] = edges[indexEdges];
 			indexSelEdges++;
 		}
@@ -385,25 +402,35 @@ void demoKruskal() {
 void generateChart() {
 	maxWeight = 50000;
 
-	Node** disjointSets;
-	Edge* edges;
-	int** adjMatrix;
+	ParallelSweep(100, 10000, 100, [](int size) {
+		Node** disjointSets;
+		Edge* edges;
+		int** adjMatrix;
 
-	for (int size = 100; size <= 10000; size += 100)
-	{
 		OP = 0;
 
-		disjointSets = createDisjointSets(size);
+		profiler.startAllocations(SETS_MEMORY, size);
+		disjointSets = createDisjointSets<CountingPolicy>(size);
+		profiler.stopAllocations(SETS_MEMORY, size);
+
 		adjMatrix = createAdjacencyMatrix(size);
 		edges = getEdgesSorted(disjointSets, adjMatrix, size);
 
 		int index = 0;
 
+		Profiler::Histogram& findSetCost = profiler.histogram(FIND_SET_COST, size);
+		auto measuredFindSet = [&](Node* node) {
+			unsigned long long before = OP;
+			Node* set = findSet<CountingPolicy>(node);
+			findSetCost.record(OP - before);
+			return set;
+		};
+
 		for (int i = 0; i < 4 * size; i++)
 		{
-			if (findSet(edges[index].src) != findSet(edges[index].dest))
+			if (measuredFindSet(edges[index].src) != measuredFindSet(edges[index].dest))
 			{
-				combineSets(findSet(edges[index].src), findSet(edges[index].dest));
+				combineSets<CountingPolicy>(measuredFindSet(edges[index].src), measuredFindSet(edges[index].dest));
 			}
 
 			index++;
@@ -414,14 +441,18 @@ void generateChart() {
 		freeMatrix(adjMatrix, size);
 
 		profiler.countOperation(COMP_EFF, size, OP);
-	}
+	});
 
 	profiler.showReport();
 }
 
+#ifndef BENCHMARK_DRIVER
 int main() {
 	demoDisjointSets();
 	demoKruskal();
 
 	generateChart();
-}
\ No newline at end of file
+
+	return profiler.hasRegressions() ? 1 : 0;
+}
+#endif
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include<stdlib.h>
 #include<stdio.h>
 #include<string.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
+
+#define PROBES_FOUND "Probes Found"
+#define PROBES_NOT_FOUND "Probes Not Found"
 
 /*
 	Hash Table
@@ -39,7 +42,9 @@
 		This can be proven mathematically or by checking with the table generated by the program.
 */
 
-int EFFORT, MAX_EFFORT;
+Profiler profiler("Hash Tables");
+
+thread_local int EFFORT, MAX_EFFORT;
 double AVG_EFFORT_F, AVG_EFFORT_NF, AVG_MAX_EFFORT_F, AVG_MAX_EFFORT_NF;
 
 typedef struct {
@@ -53,7 +58,7 @@ Entry* createEntry(int id, char name[30]) {
 	if (entry)
 	{
 		entry->id = id;
-		strcpy_s(entry->name, name);
+		snprintf(entry->name, sizeof(entry->name), "%.*s", (int)sizeof(entry->name) - 1, name);
 
 		return entry;
 	}
@@ -122,6 +127,7 @@ int insertHashTable(Entry** hashTable, Entry* entry, int size) {
 	return -1;
 }
 
+template <typename Count>
 int searchHashTable(Entry** hashTable, int id, int size) {
 	int i = 0;
 	int j;
@@ -138,7 +144,7 @@ int searchHashTable(Entry** hashTable, int id, int size) {
 		}
 
 		i++;
-		EFFORT++;
+		Count::add(EFFORT);
 	} while (i < size);
 
 	return -1;
@@ -233,17 +239,17 @@ void demo() {
 	}
 
 	printf("Searching for id: %d\n", idTrue);
-	printf("Data with id: %d found at index: %d\n\n", idTrue, searchHashTable(hashTable, idTrue, 13));
+	printf("Data with id: %d found at index: %d\n\n", idTrue, searchHashTable<NullPolicy>(hashTable, idTrue, 13));
 	
 	printf("Searching for id: %d\n", idFalse);
-	printf("Data with id: %d found at index: %d\n", idFalse,searchHashTable(hashTable, idFalse, 13));
+	printf("Data with id: %d found at index: %d\n", idFalse,searchHashTable<NullPolicy>(hashTable, idFalse, 13));
 
 	freeHashTable(hashTable, 13);
 
 	printf("\n \t\t\t DEMO END\n");
 }
 
-void searchFound(Entry** hashTable, int tableSize, int* probT, int size) {
+void searchFound(Entry** hashTable, int tableSize, int* probT, int size, Profiler::Histogram& probes) {
 	MAX_EFFORT = 0;
 	EFFORT = 0;
 	int currentEffort;
@@ -252,9 +258,10 @@ void searchFound(Entry** hashTable, int tableSize, int* probT, int size) {
 	{	
 		currentEffort = EFFORT;
 
-		searchHashTable(hashTable, probT[i], tableSize);
+		searchHashTable<CountingPolicy>(hashTable, probT[i], tableSize);
 
 		currentEffort = EFFORT - currentEffort;
+		probes.record(currentEffort);
 
 		if (currentEffort > MAX_EFFORT)
 		{
@@ -263,7 +270,7 @@ void searchFound(Entry** hashTable, int tableSize, int* probT, int size) {
 	}
 }
 
-void searchNotFound(Entry** hashTable, int tableSize, int* probF, int size) {
+void searchNotFound(Entry** hashTable, int tableSize, int* probF, int size, Profiler::Histogram& probes) {
 	MAX_EFFORT = 0;
 	EFFORT = 0;
 	int currentEffort;
@@ -272,9 +279,10 @@ void searchNotFound(Entry** hashTable, int tableSize, int* probF, int size) {
 	{
 		currentEffort = EFFORT;
 
-		searchHashTable(hashTable, probF[i], tableSize);
+		searchHashTable<CountingPolicy>(hashTable, probF[i], tableSize);
 
 		currentEffort = EFFORT - currentEffort;
+		probes.record(currentEffort);
 
 		if (currentEffort > MAX_EFFORT)
 		{
@@ -312,11 +320,11 @@ void generateTable() {
 			createSampleInput(nbOfElements, probSize, sample, probT, probF);
 			fillHashTable(hashTable, 10007, sample, nbOfElements);
 
-			searchFound(hashTable, tableSize, probT, probSize);
+			searchFound(hashTable, tableSize, probT, probSize, profiler.histogram(PROBES_FOUND, ratio[i]));
 			AVG_EFFORT_F += (double) EFFORT / probSize;
 			AVG_MAX_EFFORT_F += MAX_EFFORT;
 
-			searchNotFound(hashTable, tableSize, probF, probSize);
+			searchNotFound(hashTable, tableSize, probF, probSize, profiler.histogram(PROBES_NOT_FOUND, ratio[i]));
 			AVG_EFFORT_NF += (double) EFFORT / probSize;
 			AVG_MAX_EFFORT_NF += MAX_EFFORT;
 
@@ -335,11 +343,17 @@ void generateTable() {
 	}
 
 	printf("\n");
+
+	profiler.showReport(); // tail of the probe counts for every load factor (in %)
 }
 
-void main() {
+#ifndef BENCHMARK_DRIVER
+int main() {
 	
 	demo();
 
 	generateTable();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
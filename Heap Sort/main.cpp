@@ -1,6 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 #define TOP_DOWN_AVG "Top-Down aprroach AVG"
 #define BOTTOM_UP_AVG "Bottom-Up approach AVG"
@@ -77,21 +77,12 @@
 
 Profiler profiler("Demo Average");
 
-int TOP_DOWN_OP, T_TOP_DOWN_OP, BOTTOM_UP_OP, T_BOTTOM_UP_OP;
+thread_local unsigned long long TOP_DOWN_OP, BOTTOM_UP_OP;
 
 void initOperations() {
 	TOP_DOWN_OP = BOTTOM_UP_OP = 0;
 }
 
-void initTOperations() {
-	T_TOP_DOWN_OP = T_BOTTOM_UP_OP = 0;
-}
-
-void addOperations() {
-	T_TOP_DOWN_OP += TOP_DOWN_OP;
-	T_BOTTOM_UP_OP += BOTTOM_UP_OP;
-}
-
 int* generateArray(int size, bool unique, int sorted) {
 	int* a = (int*)malloc(size * sizeof(int));
 
@@ -137,6 +128,7 @@ void swap(int* a, int* b) {
 	*b = aux;
 }
 
+template <typename Count>
 void heapify(int* a, int size, int root) {
 	int right = 2 * root + 2;
 	int left = 2 * root + 1;
@@ -146,23 +138,24 @@ void heapify(int* a, int size, int root) {
 	{
 		index = left;
 	}
-	BOTTOM_UP_OP++;  // Counts comp
+	Count::add(BOTTOM_UP_OP);  // Counts comp
 
 	if (right < size && a[index] < a[right])
 	{
 		index = right;
 	}
-	BOTTOM_UP_OP++; // Counts comp
+	Count::add(BOTTOM_UP_OP); // Counts comp
 
 	if (index != root)
 	{
 		swap(&a[root], &a[index]);
-		heapify(a, size, index);
+		heapify<Count>(a, size, index);
 
-		BOTTOM_UP_OP += 3;  // Counts assig for the swap
+		Count::add(BOTTOM_UP_OP, 3);  // Counts assig for the swap
 	}
 }
 
+template <typename Count>
 void insertHeap(int* a, int index) {
 	int parentIndex = getParent(index);
 
@@ -174,20 +167,21 @@ void insertHeap(int* a, int index) {
 
 		parentIndex = getParent(index);
 
-		TOP_DOWN_OP += 3; // Counts assig for the swap
-		TOP_DOWN_OP++;	  // Counts comp
+		Count::add(TOP_DOWN_OP, 3); // Counts assig for the swap
+		Count::add(TOP_DOWN_OP);	  // Counts comp
 	}
 
 	if (parentIndex >= 0)
 	{
-		TOP_DOWN_OP++;    // Counts comp for the while loop end
+		Count::add(TOP_DOWN_OP);    // Counts comp for the while loop end
 	}
 }
 
+template <typename Count>
 void buildHeapBottomUp(int* a, int size, bool demo) {
 	for (int i = size / 2 - 1; i >= 0; i--)
 	{
-		heapify(a, size, i);
+		heapify<Count>(a, size, i);
 
 		if (demo)
 		{
@@ -198,10 +192,11 @@ void buildHeapBottomUp(int* a, int size, bool demo) {
 	}
 }
 
+template <typename Count>
 void buildHeapTopDown(int* a, int size, bool demo) {
 	for (int i = 1; i < size; i++)
 	{
-		insertHeap(a, i);
+		insertHeap<Count>(a, i);
 
 		if (demo)
 		{
@@ -212,11 +207,12 @@ void buildHeapTopDown(int* a, int size, bool demo) {
 	}
 }
 
+template <typename Count>
 void heapSort(int* a, int size, bool demo) {
 	int heapSize = size;
 
-	//buildHeapTopDown(a, heapSize, demo);
-	buildHeapBottomUp(a, heapSize, demo);
+	//buildHeapTopDown<Count>(a, heapSize, demo);
+	buildHeapBottomUp<Count>(a, heapSize, demo);
 
 	if (demo)
 	{
@@ -231,7 +227,7 @@ void heapSort(int* a, int size, bool demo) {
 
 		heapSize--;
 
-		heapify(a, heapSize, 0);
+		heapify<Count>(a, heapSize, 0);
 
 		if (demo)
 		{
@@ -243,58 +239,84 @@ void heapSort(int* a, int size, bool demo) {
 }
 
 void generateChartAverage() {
-	int* a;
-	int* sample;
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
+		int* sample;
 
-	for (int size = 100; size < 10000; size += 100)
-	{
-		initTOperations();
-
-		for (int j = 0; j < 5; j++) {
+		for (BenchmarkRunner run(profiler, size); run.next(); ) {
 			a = generateArray(size, false, 0);
 
 			initOperations();
 
 			sample = generateCopy(a, size);
-			buildHeapBottomUp(sample, size, false);
+			buildHeapBottomUp<CountingPolicy>(sample, size, false);
 			free(sample);
 
 			sample = generateCopy(a, size);
-			buildHeapTopDown(sample, size, false);
+			buildHeapTopDown<CountingPolicy>(sample, size, false);
 			free(sample);
 
 			free(a);
 
-			addOperations();
+			run.record(TOP_DOWN_AVG, TOP_DOWN_OP);
+			run.record(BOTTOM_UP_AVG, BOTTOM_UP_OP);
 		}
-
-		profiler.countOperation(TOP_DOWN_AVG, size, T_TOP_DOWN_OP / 5);
-		profiler.countOperation(BOTTOM_UP_AVG, size, T_BOTTOM_UP_OP / 5);
-	}
+	});
 }
 
 void generateChartWorst() {
-	int* a;
-	int* sample;
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
+		int* sample;
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		initOperations();
 
 		a = generateArray(size, false, 1);
 
 		sample = generateCopy(a, size);
-		buildHeapBottomUp(sample, size, false);
+		buildHeapBottomUp<CountingPolicy>(sample, size, false);
 		free(sample);
 
 		sample = generateCopy(a, size);
-		buildHeapTopDown(sample, size, false);
+		buildHeapTopDown<CountingPolicy>(sample, size, false);
 		free(sample);
 
 		free(a);
 
 		profiler.countOperation(TOP_DOWN_WORST, size, TOP_DOWN_OP);
 		profiler.countOperation(BOTTOM_UP_WORST, size, BOTTOM_UP_OP);
+	});
+}
+
+void generateChartDistributions() {
+	for (int method = NEARLY_SORTED; method < SORT_METHOD_COUNT; method++)
+	{
+		std::string topDownName = std::string("Top-Down approach ") + SortMethodName(method);
+		std::string bottomUpName = std::string("Bottom-Up approach ") + SortMethodName(method);
+
+		ParallelSweep(100, 9900, 100, [&](int size) {
+			int* a;
+			int* sample;
+
+			initOperations();
+
+			a = generateArray(size, false, method);
+
+			sample = generateCopy(a, size);
+			buildHeapBottomUp<CountingPolicy>(sample, size, false);
+			free(sample);
+
+			sample = generateCopy(a, size);
+			buildHeapTopDown<CountingPolicy>(sample, size, false);
+			free(sample);
+
+			free(a);
+
+			profiler.countOperation(topDownName.c_str(), size, TOP_DOWN_OP);
+			profiler.countOperation(bottomUpName.c_str(), size, BOTTOM_UP_OP);
+		});
+
+		profiler.createGroup((std::string("Distribution ") + SortMethodName(method)).c_str(), topDownName.c_str(), bottomUpName.c_str());
 	}
 }
 
@@ -307,6 +329,10 @@ void generateCharts() {
 	generateChartWorst();
 	profiler.createGroup("Worst Case", TOP_DOWN_WORST, BOTTOM_UP_WORST);
 
+	profiler.reset("Demo Distributions");
+
+	generateChartDistributions();
+
 	profiler.showReport();
 }
 
@@ -321,7 +347,7 @@ void demoHeapSort() {
 	printArray(a, 50);
 	printf("\n");
 
-	heapSort(a, 50, true);
+	heapSort<NullPolicy>(a, 50, true);
 
 	printf("Final form: ");
 	printArray(a, 50);
@@ -340,7 +366,7 @@ void demoBottomUp() {
 	printArray(a, 50);
 	printf("\n");
 
-	buildHeapBottomUp(a, 50, true);
+	buildHeapBottomUp<NullPolicy>(a, 50, true);
 
 	printf("Final form: ");
 	printArray(a, 50);
@@ -359,7 +385,7 @@ void demoTopDown() {
 	printArray(a, 50);
 	printf("\n");
 
-	buildHeapTopDown(a, 50, true);
+	buildHeapTopDown<NullPolicy>(a, 50, true);
 
 	printf("Final form: ");
 	printArray(a, 50);
@@ -367,10 +393,14 @@ void demoTopDown() {
 	printf("------------------------------------------------------------------------------------------------------------------------\n");
 }
 
+#ifndef BENCHMARK_DRIVER
 int main() {
 	demoHeapSort();
 	demoBottomUp();
 	demoTopDown();
 
 	generateCharts();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
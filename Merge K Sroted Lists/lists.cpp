@@ -1,6 +1,8 @@
 #include<stdio.h>	
 #include<stdlib.h>
 #include "List.h"
+#define PROFILER_TRACK_ALLOCATIONS
+#include "../Profiler/Profiler.h"
 
 NodeL* createNode(int key) {
 	NodeL* p = (NodeL*)malloc(sizeof(NodeL));
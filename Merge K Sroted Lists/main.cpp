@@ -1,7 +1,8 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include "List.h"
-#include "Profiler.h"
+#define PROFILER_TRACK_ALLOCATIONS
+#include "../Profiler/Profiler.h"
 
 #define VARY_N_K1 "Vary n with fixed value k = 5"
 #define VARY_N_K2 "Vary n with fixed value k = 10"
@@ -60,7 +61,7 @@ Profiler profiler("Merge K lists");
 int LEFT, RIGHT; // Represent the limits for the numbers when generating the arrays
 				// ! Set them accordingly before use !
 
-int OP;
+thread_local unsigned long long OP;
 
 void swapList(ListH** l, int indexA, int indexB) {
 	ListH* aux;
@@ -87,28 +88,31 @@ void insertArrayList(ListH* l, int* a, int size) {
 
 ListH** createLists(int k, int n) {
 	ListH** l = createArrayList(k);
-	int* a;
+	int* a = generateArray(n, 0, false); // all the keys at once, generated in parallel
+	int begin = 0;
+	int size;
 
 	for (int i = 0; i < k; i++)
 	{
 		if (i < n % k) {
-			a = generateArray(n / k + 1, 1, false);
-
-			insertArrayList(l[i], a, n / k + 1);
+			size = n / k + 1;
 		}
 		else
 		{
-			a = generateArray(n / k, 1, false);
-
-			insertArrayList(l[i], a, n / k);
+			size = n / k;
 		}
 
-		free(a);
+		std::sort(a + begin, a + begin + size);
+		insertArrayList(l[i], a + begin, size);
+		begin += size;
 	}
 
+	free(a);
+
 	return l;
 }
 
+template <typename Count>
 void heapifyList(ListH** l, int root, int size) {
 	int left = 2 * root + 1;
 	int right = 2 * root + 2;
@@ -118,34 +122,36 @@ void heapifyList(ListH** l, int root, int size) {
 	{
 		index = right;
 	}
-	OP++;
+	Count::add(OP);
 
 	if (left < size && l[index]->first->key > l[left]->first->key)
 	{
 		index = left;
 	}
-	OP++;
+	Count::add(OP);
 
 
 	if (index != root)
 	{
 		swapList(l, root, index);
-		OP += 3;
-		heapifyList(l, index, size);
+		Count::add(OP, 3);
+		heapifyList<Count>(l, index, size);
 	}
 }
 
+template <typename Count>
 void buildHeapList(ListH** l, int size) {
 	for (int i = size / 2 - 1; i >= 0; i--)
 	{
-		heapifyList(l, i, size);
+		heapifyList<Count>(l, i, size);
 	}
 }
 
+template <typename Count>
 void mergeLists(ListH** lists, int size, ListH* L, bool demo) {
 	int heapSize = size;
 
-	buildHeapList(lists, size);
+	buildHeapList<Count>(lists, size);
 
 	if (demo)
 	{
@@ -165,11 +171,11 @@ void mergeLists(ListH** lists, int size, ListH* L, bool demo) {
 		if (isEmpty(lists[0]))
 		{
 			swapList(lists, 0, heapSize - 1);
-			OP += 3;
+			Count::add(OP, 3);
 			heapSize--;
 		}
 
-		heapifyList(lists, 0, heapSize);
+		heapifyList<Count>(lists, 0, heapSize);
 
 		if (demo)
 		{
@@ -203,7 +209,7 @@ void demo() {
 	}
 	printf("\n\n");
 
-	mergeLists(lists, k, L, true);
+	mergeLists<NullPolicy>(lists, k, L, true);
 
 	printf("The resulting merged list: \n");
 	printList(L);
@@ -215,81 +221,89 @@ void demo() {
 void generateChartVaryN1() {
 	int k = 5;
 
-	ListH** lists;
-	ListH* L = createList();
+	ParallelSweep(100, 9900, 100, [&](int size) {
+		ListH** lists;
+		ListH* L = createList();
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		OP = 0;
 
+		profiler.startAllocations(VARY_N_K1, size);
 		lists = createLists(k, size);
-		mergeLists(lists, k, L, false);
+		mergeLists<CountingPolicy>(lists, k, L, false);
+		profiler.stopAllocations(VARY_N_K1, size);
 		freeArrayList(lists, k);
+		freeList(L);
 
 		profiler.countOperation(VARY_N_K1, size, OP);
-	}
+	});
 
-	freeList(L);
+	profiler.setFixedSize(VARY_N_K1, 'k', k); // fitted against n log k
 }
 
 void generateChartVaryN2() {
 	int k = 10;
 
-	ListH** lists;
-	ListH* L = createList();
+	ParallelSweep(100, 9900, 100, [&](int size) {
+		ListH** lists;
+		ListH* L = createList();
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		OP = 0;
 
+		profiler.startAllocations(VARY_N_K2, size);
 		lists = createLists(k, size);
-		mergeLists(lists, k, L, false);
+		mergeLists<CountingPolicy>(lists, k, L, false);
+		profiler.stopAllocations(VARY_N_K2, size);
 		freeArrayList(lists, k);
+		freeList(L);
 
 		profiler.countOperation(VARY_N_K2, size, OP);
-	}
+	});
 
-	freeList(L);
+	profiler.setFixedSize(VARY_N_K2, 'k', k); // fitted against n log k
 }
 
 void generateChartVaryN3() {
 	int k = 100;
 
-	ListH** lists;
-	ListH* L = createList();
+	ParallelSweep(100, 9900, 100, [&](int size) {
+		ListH** lists;
+		ListH* L = createList();
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		OP = 0;
 
+		profiler.startAllocations(VARY_N_K3, size);
 		lists = createLists(k, size);
-		mergeLists(lists, k, L, false);
+		mergeLists<CountingPolicy>(lists, k, L, false);
+		profiler.stopAllocations(VARY_N_K3, size);
 		freeArrayList(lists, k);
+		freeList(L);
 
 		profiler.countOperation(VARY_N_K3, size, OP);
-	}
+	});
 
-	freeList(L);
+	profiler.setFixedSize(VARY_N_K3, 'k', k); // fitted against n log k
 }
 
 void generateChartVaryK() {
 	int size = 10000;
 
-	ListH** lists;
-	ListH* L = createList();
+	ParallelSweep(10, 490, 10, [&](int k) {
+		ListH** lists;
+		ListH* L = createList();
 
-	for (int k = 10; k < 500; k += 10)
-	{
 		OP = 0;
 
+		profiler.startAllocations(VARY_K, k);
 		lists = createLists(k, size);
-		mergeLists(lists, k, L, false);
+		mergeLists<CountingPolicy>(lists, k, L, false);
+		profiler.stopAllocations(VARY_K, k);
 		freeArrayList(lists, k);
+		freeList(L);
 
 		profiler.countOperation(VARY_K, k, OP);
-	}
+	});
 
-	freeList(L);
+	profiler.setFixedSize(VARY_K, 'n', size); // fitted against n log k
 }
 
 void generateCharts() {
@@ -309,8 +323,12 @@ void generateCharts() {
 	profiler.showReport();
 }
 
+#ifndef BENCHMARK_DRIVER
 int main() {
 	demo();
 
 	generateCharts();
-}
\ No newline at end of file
+
+	return profiler.hasRegressions() ? 1 : 0;
+}
+#endif
\ No newline at end of file
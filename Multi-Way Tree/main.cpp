@@ -1,7 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>	
 #include <fstream>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 Profiler profiler("Multi-Way Tree");
 
@@ -1,6 +1,6 @@
 #include<stdlib.h>
 #include<stdio.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 Profiler profiler("OS Tree");
 
@@ -254,7 +254,7 @@ int findHeight(Tree* T) {
 	return maxHeight;
 }
 
-void main() {
+int main() {
 	MIN = 1;
 	MAX = 99;
 	Tree* T = buildTree(10);
@@ -262,5 +262,7 @@ void main() {
 
 	printTree(T->root, 0);
 	traversal(T);
+
+	return 0;
 }
 
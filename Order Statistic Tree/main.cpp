@@ -1,6 +1,6 @@
 #include<stdlib.h>
 #include<stdio.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 /*
 
@@ -48,10 +48,12 @@
 #define AVG_EFFORT_OS_DELETE "Average comp. effort OS_Delete"
 #define AVG_EFFORT_OS_SELECT "Average comp. effort OS_Select"
 #define AVG_EFFORT_BUILD_TREE "Average comp. effort Build Tree"
+#define OS_SELECT_COST "Operations per OS_Select"
+#define OS_DELETE_COST "Operations per OS_Delete"
 
 Profiler profiler("OS Tree");
 
-int OS_S_OP, OS_D_OP, OS_S_OP_T, OS_D_OP_T, BUILD_OP;
+thread_local unsigned long long OS_S_OP, OS_D_OP, OS_S_OP_T, OS_D_OP_T, BUILD_OP;
 
 int MIN, MAX;
 
@@ -126,55 +128,57 @@ void freeTree(Tree* T) {
 	free(T);
 }
 
+template <typename Count>
 bool insertTree(Tree* T, int key) {
 	NodeT* node = createNode(key);
 	T->size++;
 
 	if (T->root == NULL) {
 		T->root = node;
-		BUILD_OP++;
+		Count::add(BUILD_OP);
 		return true;
 	}
-	BUILD_OP++;
+	Count::add(BUILD_OP);
 
 	NodeT* root = T->root;
 
 	while (root) {
 		root->dim++;
-		BUILD_OP++;
+		Count::add(BUILD_OP);
 
 		if (node->key > root->key) {
 			if (root->right == NULL) {
 				root->right = node;
 				node->parent = root;
-				BUILD_OP += 2;
+				Count::add(BUILD_OP, 2);
 				return true;
 			}
-			BUILD_OP++;
+			Count::add(BUILD_OP);
 
 			root = root->right;
-			BUILD_OP++;
+			Count::add(BUILD_OP);
 		}
 		else {
 			if (root->left == NULL) {
 				root->left = node;
 				node->parent = root;
-				BUILD_OP += 2;
+				Count::add(BUILD_OP, 2);
 				return true;
 			}
-			BUILD_OP++;
+			Count::add(BUILD_OP);
 
 			root = root->left;
-			BUILD_OP++;
+			Count::add(BUILD_OP);
 		}
-		BUILD_OP++;
+		Count::add(BUILD_OP);
 	}
 
 	return false;
 }
 
+template <typename Count>
 NodeT* OS_Select(NodeT* root, int index) {
-	OS_S_OP++;
+	Count::add(OS_S_OP);
 
 	if (root)
 	{
@@ -182,11 +186,11 @@ NodeT* OS_Select(NodeT* root, int index) {
 
 		if (root->left) {
 			indexRoot = root->left->dim + 1;
-			OS_S_OP++;
+			Count::add(OS_S_OP);
 		}
-		OS_S_OP++;
+		Count::add(OS_S_OP);
 
-		OS_S_OP++;
+		Count::add(OS_S_OP);
 		if (index == indexRoot)
 		{
 			return root;
@@ -194,120 +198,126 @@ NodeT* OS_Select(NodeT* root, int index) {
 		else {
 			if (index > indexRoot)
 			{
-				return OS_Select(root->right, index - indexRoot);
+				return OS_Select<Count>(root->right, index - indexRoot);
 			}
-			OS_S_OP++;
+			Count::add(OS_S_OP);
 
-			return OS_Select(root->left, index);
+			return OS_Select<Count>(root->left, index);
 		}
 	}
 
 	return NULL;
 }
 
+template <typename Count>
 void updateDim(NodeT* node) {
 	while (node)
 	{
 		node->dim--;
 		node = node->parent;
-		OS_D_OP += 2;
+		Count::add(OS_D_OP, 2);
 	}
 }
 
+template <typename Count>
 void replaceChild(Tree* T, NodeT* root, NodeT* child, NodeT* newChild) {
-	updateDim(root);
+	updateDim<Count>(root);
 
 	if (root == NULL)
 	{
 		T->root = newChild;
-		OS_D_OP++;
+		Count::add(OS_D_OP);
 	}
 	else if (root->left == child)
 	{
 		root->left = newChild;
-		OS_D_OP++;
+		Count::add(OS_D_OP);
 	}
 	else if (root->right == child)
 	{
 		root->right = newChild;
-		OS_D_OP++;
+		Count::add(OS_D_OP);
 	}
 
 	if (newChild)
 	{
 		newChild->parent = root;
-		OS_D_OP++;
+		Count::add(OS_D_OP);
 	}
-	OS_D_OP += 4;
+	Count::add(OS_D_OP, 4);
 }
 
+template <typename Count>
 void deleteNode(Tree* T, NodeT* node) {
 	if (node)
 	{
 		if (node->left == NULL && node->right == NULL)
 		{
-			replaceChild(T, node->parent, node, NULL);
+			replaceChild<Count>(T, node->parent, node, NULL);
 			free(node);
 		}
 		else if (node->left != NULL && node->right == NULL)
 		{
-			replaceChild(T, node->parent, node, node->left);
+			replaceChild<Count>(T, node->parent, node, node->left);
 			free(node);
 		}
 		else if (node->left == NULL && node->right != NULL)
 		{
-			replaceChild(T, node->parent, node, node->right);
+			replaceChild<Count>(T, node->parent, node, node->right);
 			free(node);
 		}
 		else
 		{
 			NodeT* min = node->right;
-			OS_D_OP++;
+			Count::add(OS_D_OP);
 
 			while (min->left)
 			{
 				min = min->left;
-				OS_D_OP++;
+				Count::add(OS_D_OP);
 			}
 
 			node->key = min->key;
-			OS_D_OP++;
+			Count::add(OS_D_OP);
 
-			deleteNode(T, min);
+			deleteNode<Count>(T, min);
 		}
-		OS_D_OP += 3;
+		Count::add(OS_D_OP, 3);
 	}
-	OS_D_OP++;
+	Count::add(OS_D_OP);
 }
 
+template <typename Count>
 void OS_Delete(Tree* T, int index) {
 	if (T->size > 0)
 	{
-		NodeT* node = OS_Select(T->root, index);
+		NodeT* node = OS_Select<Count>(T->root, index);
 
-		deleteNode(T, node);
+		deleteNode<Count>(T, node);
 
 		T->size--;
 	}
 }
 
+template <typename Count>
 void createBalancedTree(Tree* T, int* a, int l, int r) {
 	if (r >= l)
 	{
 		int middle = (r + l) / 2;
 
-		insertTree(T, a[middle]);
+		insertTree<Count>(T, a[middle]);
 
-		createBalancedTree(T, a, l, middle - 1);
-		createBalancedTree(T, a, middle + 1, r);
+		createBalancedTree<Count>(T, a, l, middle - 1);
+		createBalancedTree<Count>(T, a, middle + 1, r);
 	}
 }
 
+template <typename Count>
 Tree* buildTree(int n) {
 	int* a = generateArray(n, 0, 1);
 	Tree* T = createTree();
 
-	createBalancedTree(T, a, 0, n - 1);
+	createBalancedTree<Count>(T, a, 0, n - 1);
 
 	return T;
 }
@@ -338,7 +348,7 @@ void demo() {
 	printf("\n\t\t\t\t THIS IS A DEMO BUILD TREE OS_SELECT OS_DELETE\n");
 	MIN = 1;
 	MAX = 11;
-	Tree* T = buildTree(11);
+	Tree* T = buildTree<NullPolicy>(11);
 
 	printf("\t TREE AFTER CREATION\n");
 	printTree(T->root, 0);
@@ -353,10 +363,10 @@ void demo() {
 		//index = 1 + rand() % T->size;
 		index = T->size / 2 + 1;
 
-		printf("Element at index %d is: %d\n", index, OS_Select(T->root, index)->key);
+		printf("Element at index %d is: %d\n", index, OS_Select<NullPolicy>(T->root, index)->key);
 		printf("Tree after deletion of element at index %d :\n", index);
 
-		OS_Delete(T, index);
+		OS_Delete<NullPolicy>(T, index);
 
 		printTree(T->root, 0);
 	}
@@ -369,49 +379,57 @@ void generateChart() {
 	MIN = 10;
 	MAX = 50000;
 
-	Tree* T;
+	ParallelSweep(100, 10000, 100, [](int size) {
+		Tree* T;
+		int index;
 
-	int index;
-	srand(time(NULL));
+		for (BenchmarkRunner run(profiler, size); run.next(); ) {
+			// per run, the runner keeps them only for the runs it does not reject
+			Profiler::Histogram selectCost, deleteCost;
 
-	for (int size = 100; size <= 10000; size += 100)
-	{
-		OS_D_OP_T = 0;
-		OS_S_OP_T = 0;
-		BUILD_OP = 0;
+			OS_D_OP_T = 0;
+			OS_S_OP_T = 0;
+			BUILD_OP = 0;
 
-		for (int j = 0; j < 5; j++) {
-			T = buildTree(size);
+			T = buildTree<CountingPolicy>(size);
 
 			for (int i = 0; i < T->size; i++)
 			{
 				OS_S_OP = 0;
 				OS_D_OP = 0;
 
-				index = 1 + rand() % T->size;
+				index = 1 + (int)RandomEngine().nextBelow(T->size);
 
-				OS_Select(T->root, index);
+				OS_Select<CountingPolicy>(T->root, index);
 				OS_S_OP_T += OS_S_OP;
 				OS_D_OP_T += OS_S_OP;
+				selectCost.record(OS_S_OP);
 
-				OS_Delete(T, index);
+				OS_Delete<CountingPolicy>(T, index);
 				OS_D_OP_T += OS_D_OP;
+				deleteCost.record(OS_D_OP);
 			}
 
 			freeTree(T);
-		}
 
-		profiler.countOperation(AVG_EFFORT_OS_DELETE, size, OS_D_OP_T / 5);
-		profiler.countOperation(AVG_EFFORT_OS_SELECT, size, OS_S_OP_T / 5);
-		profiler.countOperation(AVG_EFFORT_BUILD_TREE, size, BUILD_OP / 5);
-	}
+			run.record(AVG_EFFORT_OS_DELETE, OS_D_OP_T);
+			run.record(AVG_EFFORT_OS_SELECT, OS_S_OP_T);
+			run.record(AVG_EFFORT_BUILD_TREE, BUILD_OP);
+			run.record(OS_SELECT_COST, selectCost);
+			run.record(OS_DELETE_COST, deleteCost);
+		}
+	});
 
 	profiler.showReport();
 }
 
-void main() {
+#ifndef BENCHMARK_DRIVER
+int main() {
 	demo();
 
-	//generateChart();
+	generateChart();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
 
@@ -0,0 +1,28 @@
+#include <ctype.h>
+#include "Benchmark.h"
+
+std::vector<Benchmark*>& Benchmark::registry() {
+	static std::vector<Benchmark*> benchmarks;
+	return benchmarks;
+}
+
+bool Benchmark::matches(const std::string& name, const char* given) {
+	size_t i = 0;
+
+	for (;;) {
+		while (i < name.size() && (name[i] == ' ' || name[i] == '-')) {
+			++i;
+		}
+		while (*given == ' ' || *given == '-') {
+			++given;
+		}
+		if (i == name.size() || *given == '\0') {
+			return i == name.size() && *given == '\0';
+		}
+		if (tolower((unsigned char)name[i]) != tolower((unsigned char)*given)) {
+			return false;
+		}
+		++i;
+		++given;
+	}
+}
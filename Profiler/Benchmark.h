@@ -0,0 +1,290 @@
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+#include "Profiler.h"
+
+/**
+* one benchmark of the driver (see Benchmark Driver/main.cpp): a set of
+* algorithms, each run on the inputs of every generator at every size of a
+* range, with a series per metric read after the runs
+* benchmarks are created through RegisterBenchmark, usually while the
+* static objects of the driver are constructed
+*/
+class Benchmark {
+public:
+	Benchmark(const char* module, const char* name)
+		: moduleName(module), benchmarkName(name), axis("elements"), first(100), last(10000), step(100) {
+	}
+
+	virtual ~Benchmark() {}
+
+	const std::string& module() const {
+		return moduleName;
+	}
+
+	const std::string& name() const {
+		return benchmarkName;
+	}
+
+	long long firstSize() const {
+		return first;
+	}
+
+	long long lastSize() const {
+		return last;
+	}
+
+	long long sizeStep() const {
+		return step;
+	}
+
+	/**
+	* what the size of a point is, "elements" unless the benchmark says otherwise
+	* (the load factor of a hash table, ...); the driver's --sizes only applies
+	* to the benchmarks of element counts
+	*/
+	const std::string& sizeAxis() const {
+		return axis;
+	}
+
+	/**
+	* runs every algorithm on every input for size = first, first + step, ... up to
+	* last (in a ParallelSweep) and groups the series of each input and metric
+	*/
+	virtual void run(Profiler& profiler, long long first, long long last, long long step) = 0;
+
+	/**
+	* every registered benchmark, in the order they were registered
+	*/
+	static std::vector<Benchmark*>& registry();
+
+	/**
+	* true if name is the same as given, ignoring the case, the spaces and the
+	* dashes ("heapsort" matches "Heap Sort"), so names are easy to type
+	*/
+	static bool matches(const std::string& name, const char* given);
+
+protected:
+	std::string moduleName;
+	std::string benchmarkName;
+	std::string axis;
+	long long first, last, step;
+};
+
+/**
+* a benchmark whose inputs are of type Input, built through its chained setters:
+*	RegisterBenchmark<int*>("Heap Sort", "Build Heap")
+*		.sizes(100, 9900, 100)
+*		.input("random", [](int size) { return generateArray(size, false, UNSORTED); })
+*		.release([](int*& a, int) { free(a); })
+*		.reset(initOperations)
+*		.algorithm("Bottom-Up", [](int*& a, int size) { buildHeapBottomUp<CountingPolicy>(a, size, false); })
+*		.metric("operations", []() { return (double)(TOP_DOWN_OP + BOTTOM_UP_OP); });
+* every point of every algorithm is repeated by a BenchmarkRunner; the counted
+* run of each repetition does reset(), builds the input, runs the algorithm and
+* reads the metrics into "<algorithm> <input> <metric>", so the counters of
+* the generator are part of the metrics; an algorithm with a timed kernel
+* then runs it on the same input again and times it as "<algorithm> <input>"
+* the inputs of repetition r are drawn from the same random stream for every
+* algorithm, so all the algorithms of a point see the same data
+*/
+template <typename Input>
+class BenchmarkOf : public Benchmark {
+public:
+	typedef std::function<Input(int size)> Generator;
+	typedef std::function<void(Input& input, int size)> Algorithm;
+	typedef std::function<double()> Metric;
+
+	BenchmarkOf(const char* module, const char* name) : Benchmark(module, name) {
+	}
+
+	/**
+	* the default size range, the driver may replace it if the sizes are
+	* element counts; any other sizeAxis names what they are
+	*/
+	BenchmarkOf& sizes(long long firstSize, long long lastSize, long long sizeStep, const char* sizeAxis = "elements") {
+		first = firstSize;
+		last = lastSize;
+		step = sizeStep;
+		axis = sizeAxis;
+		return *this;
+	}
+
+	/**
+	* called once before every sweep, for the global settings of the module
+	*/
+	BenchmarkOf& setup(std::function<void()> function) {
+		setups.push_back(function);
+		return *this;
+	}
+
+	BenchmarkOf& input(const std::string& name, Generator generate) {
+		inputs.push_back(NamedInput(name, generate));
+		return *this;
+	}
+
+	/**
+	* frees an input once the algorithm is done with it
+	*/
+	BenchmarkOf& release(Algorithm function) {
+		releaseInput = function;
+		return *this;
+	}
+
+	/**
+	* clears the counters read by the metrics, called before every counted run
+	*/
+	BenchmarkOf& reset(std::function<void()> function) {
+		resetCounters = function;
+		return *this;
+	}
+
+	/**
+	* counted is the instrumented kernel the metrics are read after; timed, if
+	* given, is the uninstrumented one and gets a time series; an algorithm
+	* that is only timed passes Algorithm() as counted
+	*/
+	BenchmarkOf& algorithm(const std::string& name, Algorithm counted, Algorithm timed = Algorithm()) {
+		algorithms.push_back(NamedAlgorithm(name, counted, timed));
+		return *this;
+	}
+
+	BenchmarkOf& metric(const std::string& name, Metric read) {
+		metrics.push_back(std::make_pair(name, read));
+		return *this;
+	}
+
+	void run(Profiler& profiler, long long firstSize, long long lastSize, long long sizeStep) {
+		for (size_t i = 0; i < setups.size(); ++i) {
+			setups[i]();
+		}
+		ParallelSweep(firstSize, lastSize, sizeStep, [&](long long size) {
+			runPoint(profiler, (int)size);
+		});
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			for (size_t m = 0; m < metrics.size(); ++m) {
+				std::vector<std::string> members;
+				for (size_t a = 0; a < algorithms.size(); ++a) {
+					members.push_back(seriesName(a, i) + " " + metrics[m].first);
+				}
+				profiler.createGroup((benchmarkName + " " + inputs[i].name + " " + metrics[m].first).c_str(), members);
+			}
+		}
+	}
+
+private:
+	struct NamedInput {
+		std::string name;
+		Generator generate;
+
+		NamedInput(const std::string& n, Generator g) : name(n), generate(g) {}
+	};
+
+	struct NamedAlgorithm {
+		std::string name;
+		Algorithm counted;
+		Algorithm timed;
+
+		NamedAlgorithm(const std::string& n, Algorithm c, Algorithm t) : name(n), counted(c), timed(t) {}
+	};
+
+	std::vector<std::function<void()> > setups;
+	std::vector<NamedInput> inputs;
+	std::vector<NamedAlgorithm> algorithms;
+	std::vector<std::pair<std::string, Metric> > metrics;
+	Algorithm releaseInput;
+	std::function<void()> resetCounters;
+
+	std::string seriesName(size_t algorithm, size_t input) const {
+		return algorithms[algorithm].name + " " + inputs[input].name;
+	}
+
+	/**
+	* builds input number index of repetition run from its own random stream,
+	* the algorithms keep drawing from the stream of the point
+	*/
+	Input generate(size_t index, int size, unsigned long long seed, int run) {
+		RandomGenerator stream(seed + index, (unsigned long long)run);
+		RandomGenerator* point = PointEngine();
+		PointEngine() = &stream;
+		Input input = inputs[index].generate(size);
+		PointEngine() = point;
+		return input;
+	}
+
+	void discard(Input& input, int size) {
+		if (releaseInput) {
+			releaseInput(input, size);
+		}
+	}
+
+	void runPoint(Profiler& profiler, int size) {
+		unsigned long long seed = RandomEngine().next();
+
+		for (size_t i = 0; i < inputs.size(); ++i) {
+			for (size_t a = 0; a < algorithms.size(); ++a) {
+				const NamedAlgorithm& algorithm = algorithms[a];
+				std::string series = seriesName(a, i);
+				std::vector<std::string> metricNames;
+				for (size_t m = 0; m < metrics.size(); ++m) {
+					metricNames.push_back(series + " " + metrics[m].first);
+				}
+				int run = 0;
+
+				for (BenchmarkRunner runner(profiler, size); runner.next(); ++run) {
+					if (algorithm.counted) {
+						if (resetCounters) {
+							resetCounters();
+						}
+						Input input = generate(i, size, seed, run);
+						{
+							Profiler::ScopedTrace trace(profiler, (series + " counted").c_str());
+							algorithm.counted(input, size);
+						}
+						for (size_t m = 0; m < metrics.size(); ++m) {
+							runner.record(metricNames[m].c_str(), metrics[m].second());
+						}
+						discard(input, size);
+					}
+
+					if (algorithm.timed) {
+						Input copy = generate(i, size, seed, run);
+						Profiler::ScopedTrace trace(profiler, (series + " timed").c_str());
+						runner.time(series.c_str(), [&]() { algorithm.timed(copy, size); });
+						discard(copy, size);
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+* creates a benchmark and adds it to the registry; the benchmark lives as
+* long as the program, so the returned reference can be kept
+*/
+template <typename Input>
+BenchmarkOf<Input>& RegisterBenchmark(const char* module, const char* name) {
+	BenchmarkOf<Input>* benchmark = new BenchmarkOf<Input>(module, name);
+	Benchmark::registry().push_back(benchmark);
+	return *benchmark;
+}
+
+/**
+* a benchmark of sorting algorithms: int arrays of values in [range_min, range_max],
+* one input for every SortMethod
+*/
+inline BenchmarkOf<int*>& RegisterSortBenchmark(const char* module, const char* name, int range_min = 10, int range_max = 50000) {
+	BenchmarkOf<int*>& benchmark = RegisterBenchmark<int*>(module, name);
+
+	for (int method = UNSORTED; method < SORT_METHOD_COUNT; ++method) {
+		benchmark.input(SortMethodName(method), [=](int size) {
+			int* a = (int*)malloc(size * sizeof(int));
+			FillRandomArray(a, size, range_min, range_max, false, method);
+			return a;
+		});
+	}
+	return benchmark.release([](int*& a, int) { free(a); });
+}
+
+#endif
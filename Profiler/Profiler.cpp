@@ -1,29 +1,1149 @@
-#ifndef _PROFILER_H
-#define _PROFILER_H
+#include "Profiler.h"
 
-#ifndef _CRT_SECURE_CPP_OVERLOAD_STANDARD_NAMES
-#define _CRT_SECURE_CPP_OVERLOAD_STANDARD_NAMES 1
+/**
+* the parts of the profiler that only run around the measurements (merging,
+* fitting, the reports and their html page), compiled once for all the modules
+*/
+
+class Profiler::ReportWriter {
+	FILE* fout;
+	std::vector<char> buffer;
+	size_t used;
+public:
+	ReportWriter(FILE* f) : fout(f), buffer(1 << 16), used(0) {}
+	~ReportWriter() { flush(); }
+
+	void write(const char* data, size_t length) {
+		if (used + length > buffer.size()) {
+			flush();
+			if (length > buffer.size()) {
+				fwrite(data, 1, length, fout);
+				return;
+			}
+		}
+		memcpy(&buffer[used], data, length);
+		used += length;
+	}
+
+	void text(const char* str) { write(str, strlen(str)); }
+
+	void character(char c) {
+		if (used == buffer.size()) {
+			flush();
+		}
+		buffer[used++] = c;
+	}
+
+	void number(unsigned long long value) {
+		char digits[24];
+		int length = 0;
+		do {
+			digits[sizeof(digits) - 1 - length++] = (char)('0' + value % 10);
+			value /= 10;
+		} while (value != 0);
+		write(digits + sizeof(digits) - length, length);
+	}
+
+	void number(long long value) {
+		if (value < 0) {
+			character('-');
+			number(0ULL - (unsigned long long)value);
+		}
+		else {
+			number((unsigned long long)value);
+		}
+	}
+
+	void number(double value, int decimals = 1) {
+		char digits[64];
+#ifdef _MSC_VER
+		_snprintf_s(
+#else
+		snprintf(
+#endif
+			digits, sizeof(digits), "%.*f", decimals, value);
+		text(digits);
+	}
+
+	/**
+	* a value of an opcount series: whole numbers exactly, fractions (averages,
+	* medians of an even count of runs) with up to 4 decimals
+	*/
+	void value(double v) {
+		if (v == floor(v) && fabs(v) < 9e18) {
+			number((long long)v);
+			return;
+		}
+		char digits[64];
+		int length;
+#ifdef _MSC_VER
+		length = _snprintf_s(
+#else
+		length = snprintf(
+#endif
+			digits, sizeof(digits), "%.4f", v);
+		while (length > 0 && digits[length - 1] == '0') {
+			length--;
+		}
+		if (length > 0 && digits[length - 1] == '.') {
+			length--;
+		}
+		write(digits, (size_t)length);
+	}
+
+	void flush() {
+		if (used != 0) {
+			fwrite(&buffer[0], 1, used, fout);
+			used = 0;
+		}
+	}
+};
+
+class Profiler::BaselineParser {
+	const std::string& text;
+	size_t pos;
+public:
+	BaselineParser(const std::string& text) : text(text), pos(0) {}
+
+	bool parseReport(BaselineMap& opcount, BaselineMap& times) {
+		std::string key;
+		if (!expect('{')) {
+			return false;
+		}
+		while (!peek('}')) {
+			if (!parseString(key) || !expect(':')) {
+				return false;
+			}
+			if (key == "opcount" || key == "times") {
+				if (!parseSection(key == "opcount" ? opcount : times)) {
+					return false;
+				}
+			}
+			else if (!skipValue()) {
+				return false;
+			}
+			if (!peek('}') && !expect(',')) {
+				return false;
+			}
+		}
+		return expect('}');
+	}
+
+private:
+	bool parseSection(BaselineMap& section) {
+		std::string name;
+		double size, value;
+		if (!expect('{')) {
+			return false;
+		}
+		while (!peek('}')) {
+			if (!parseString(name) || !expect(':') || !expect('[')) {
+				return false;
+			}
+			while (!peek(']')) {
+				if (!expect('[') || !parseNumber(size) || !expect(',') || !parseNumber(value) || !expect(']')) {
+					return false;
+				}
+				section[name][(SIZE_MEASURE)size] = value;
+				if (!peek(']') && !expect(',')) {
+					return false;
+				}
+			}
+			if (!expect(']') || (!peek('}') && !expect(','))) {
+				return false;
+			}
+		}
+		return expect('}');
+	}
+
+	void skipSpace() {
+		while (pos < text.size() && isspace((unsigned char)text[pos])) {
+			++pos;
+		}
+	}
+
+	bool peek(char c) {
+		skipSpace();
+		return pos < text.size() && text[pos] == c;
+	}
+
+	bool expect(char c) {
+		if (!peek(c)) {
+			return false;
+		}
+		++pos;
+		return true;
+	}
+
+	bool parseString(std::string& value) {
+		value.clear();
+		if (!expect('"')) {
+			return false;
+		}
+		while (pos < text.size() && text[pos] != '"') {
+			if (text[pos] == '\\' && pos + 1 < text.size()) {
+				++pos;
+				if (text[pos] == 'u' && pos + 4 < text.size()) {
+					value += (char)strtol(text.substr(pos + 1, 4).c_str(), NULL, 16);
+					pos += 4;
+				}
+				else {
+					value += text[pos] == 'n' ? '\n' : text[pos] == 't' ? '\t' : text[pos];
+				}
+			}
+			else {
+				value += text[pos];
+			}
+			++pos;
+		}
+		return expect('"');
+	}
+
+	bool parseNumber(double& value) {
+		char* end;
+		skipSpace();
+		value = strtod(text.c_str() + pos, &end);
+		if (end == text.c_str() + pos) {
+			return false;
+		}
+		pos = end - text.c_str();
+		return true;
+	}
+
+	bool skipValue() {
+		std::string ignored;
+		double number;
+		if (peek('"')) {
+			return parseString(ignored);
+		}
+		if (peek('{') || peek('[')) {
+			char close = text[pos] == '{' ? '}' : ']';
+			++pos;
+			while (!peek(close)) {
+				if (close == '}' && (!parseString(ignored) || !expect(':'))) {
+					return false;
+				}
+				if (!skipValue() || (!peek(close) && !expect(','))) {
+					return false;
+				}
+			}
+			return expect(close);
+		}
+		if (parseNumber(number)) {
+			return true;
+		}
+		while (pos < text.size() && isalpha((unsigned char)text[pos])) {
+			++pos;
+		}
+		return true;
+	}
+};
+
+void Profiler::reset(const char* newTitle) {
+	mergeShards();
+	if (opcountMap.size() != 0 || timeMap.size() != 0 || histograms.size() != 0) {
+		showReport();
+	}
+	title = newTitle ? newTitle : "Title";
+	groups.clear();
+	fixedSizes.clear();
+	opcountMap.clear();
+	timeMap.clear();
+	traceEvents.clear();
+	histograms.clear();
+	std::lock_guard<std::mutex> lock(shardLock);
+	for (size_t i = 0; i < shards.size(); ++i) {
+		shards[i]->runningTimers.clear();
+		shards[i]->runningHwCounters.clear();
+	}
+}
+
+Profiler::OperationId Profiler::registerOperation(const char* name, int bucketWidth) {
+	std::lock_guard<std::mutex> lock(shardLock);
+	OperationId op;
+	for (op.index = 0; op.index < (int)registered.size(); ++op.index) {
+		if (registered[op.index].name == name) {
+			return op;
+		}
+	}
+	RegisteredOperation entry;
+	entry.name = name;
+	entry.bucketWidth = bucketWidth > 0 ? bucketWidth : 1;
+	registered.push_back(entry);
+	return op;
+}
+
+void Profiler::stopHardwareCounters(const char* name, SIZE_MEASURE size) {
+	HwReading stop;
+	CounterShard& shard = localShard();
+	readHardwareCounters(shard, stop);
+	std::map<TimerKey, HwReading>::iterator it = shard.runningHwCounters.find(TimerKey(name, size));
+	if (it == shard.runningHwCounters.end()) {
+		return;
+	}
+	for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+		if (shard.hwEventFd[i] < 0) {
+			continue;
+		}
+		double value = (double)(stop.value[i] - it->second.value[i]);
+		unsigned long long enabled = stop.enabled[i] - it->second.enabled[i];
+		unsigned long long running = stop.running[i] - it->second.running[i];
+		//the kernel multiplexes the counters when there are more events than registers
+		if (running != 0 && running < enabled) {
+			value = value * enabled / running;
+		}
+		shard.opcountMap[std::string(name) + hwEventSuffix(i)][size] += value;
+	}
+	shard.runningHwCounters.erase(it);
+}
+
+void Profiler::stopAllocations(const char* name, SIZE_MEASURE size) {
+	AllocationStats& stats = LocalAllocations();
+	CounterShard& shard = localShard();
+	std::map<TimerKey, AllocationStats>::iterator it = shard.runningAllocations.find(TimerKey(name, size));
+	if (it == shard.runningAllocations.end()) {
+		return;
+	}
+	long long peak = std::max(stats.peak - it->second.live, 0LL);
+	double& peakSeries = shard.opcountMap[std::string(name) + " peak bytes"][size];
+	shard.opcountMap[std::string(name) + " allocations"][size] += stats.count - it->second.count;
+	shard.opcountMap[std::string(name) + " bytes"][size] += stats.bytes - it->second.bytes;
+	peakSeries = std::max(peakSeries, (double)peak);
+	stats.peak = std::max(stats.peak, it->second.peak); // the peak of an enclosing recording
+	shard.runningAllocations.erase(it);
+}
+
+void Profiler::divideHardwareCounters(const char* name, OPCOUNT_MEASURE divisor) {
+	for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+		divideValues((std::string(name) + hwEventSuffix(i)).c_str(), divisor);
+	}
+}
+
+void Profiler::createGroup(const char* groupName, const char* member1, const char* member2,
+	const char* member3, const char* member4,
+	const char* member5, const char* member6,
+	const char* member7, const char* member8,
+	const char* member9, const char* member10) {
+	groups[groupName] = std::vector<std::string>();
+	//this is a bad coding style
+	//kids, don't do this at home
+#define ADD_MEMBER(member) if(member) {groups[groupName].push_back(member);}
+	ADD_MEMBER(member1);
+	ADD_MEMBER(member2);
+	ADD_MEMBER(member3);
+	ADD_MEMBER(member4);
+	ADD_MEMBER(member5);
+	ADD_MEMBER(member6);
+	ADD_MEMBER(member7);
+	ADD_MEMBER(member8);
+	ADD_MEMBER(member9);
+	ADD_MEMBER(member10);
+#undef ADD_MEMBER
+}
+
+void Profiler::createGroup(const char* groupName, const std::vector<std::string>& members) {
+	groups[groupName] = members;
+}
+
+Profiler::ComplexityFit Profiler::fitComplexity(const char* series) {
+	mergeShards();
+	std::vector<std::pair<double, double> > points;
+	OpcountMap::const_iterator it = opcountMap.find(series);
+	if (it != opcountMap.end()) {
+		for (OpcountSequence::const_iterator pit = it->second.begin(); pit != it->second.end(); ++pit) {
+			points.push_back(std::make_pair((double)pit->first, (double)pit->second));
+		}
+	}
+	return fitPoints(series, points);
+}
+
+void Profiler::addSeries(const char* newName, const char* series1, const char* series2) {
+	mergeShards();
+	if (opcountMap.find(series1) != opcountMap.end() &&
+		opcountMap.find(series2) != opcountMap.end()) {
+		OpcountSequence::const_iterator it1, it2;
+		opcountMap[newName] = OpcountSequence();
+		for (it1 = opcountMap[series1].begin(); it1 != opcountMap[series1].end(); ++it1) {
+			it2 = opcountMap[series2].find(it1->first);
+			if (it2 != opcountMap[series2].end()) {
+				opcountMap[newName][it1->first] = it1->second + it2->second;
+			}
+			else {
+				opcountMap[newName][it1->first] = it1->second;
+			}
+		}
+	}
+}
+
+void Profiler::divideValues(const char* series, OPCOUNT_MEASURE divisor) {
+	mergeShards();
+	if (opcountMap.find(series) != opcountMap.end() && divisor != 0) {
+		OpcountSequence::iterator it;
+		for (it = opcountMap[series].begin(); it != opcountMap[series].end(); ++it) {
+			it->second /= divisor;
+		}
+	}
+}
+
+bool Profiler::loadBaseline(const char* fileName) {
+	FILE* fin = NULL;
+	std::string text;
+	char buffer[1 << 16];
+	size_t length;
+#ifdef _MSC_VER
+	fopen_s(&fin, fileName, "rb");
+#else
+	fin = fopen(fileName, "rb");
+#endif
+	if (fin == NULL) {
+		return false;
+	}
+	while ((length = fread(buffer, 1, sizeof(buffer), fin)) > 0) {
+		text.append(buffer, length);
+	}
+	fclose(fin);
+	baselineLoaded = true;
+	BaselineParser parser(text);
+	return parser.parseReport(baselineOpcount, baselineTimes);
+}
+
+int Profiler::showReport() {
+	char baseName[200];
+	time_t crtTime = time(0);
+	struct tm now;
+	int status = 0;
+	mergeShards();
+	addHistogramSeries();
+#ifdef _MSC_VER
+	localtime_s(&now, &crtTime);
+#else
+	now = *localtime(&crtTime);
+#endif
+
+#ifdef _MSC_VER
+	_snprintf_s(
+#else
+	snprintf(
 #endif
+		baseName, sizeof(baseName),
+		"report-%s-%04d%02d%02d-%02d%02d%02d",
+		title.c_str(),
+		now.tm_year + 1900,
+		now.tm_mon + 1,
+		now.tm_mday,
+		now.tm_hour,
+		now.tm_min,
+		now.tm_sec
+	);
+	std::string reportName = reportFileName.empty() ? std::string(baseName) : reportFileName;
+	if ((reportFormats & REPORT_HTML) && writeReport(reportName, REPORT_HTML) != 0) {
+		status = -1;
+	}
+	if ((reportFormats & REPORT_JSON) && writeReport(reportName, REPORT_JSON) != 0) {
+		status = -1;
+	}
+	if ((reportFormats & REPORT_CSV) && writeReport(reportName, REPORT_CSV) != 0) {
+		status = -1;
+	}
+	if ((reportFormats & REPORT_TRACE) && writeReport(reportName, REPORT_TRACE) != 0) {
+		status = -1;
+	}
+	if (!baselineLoaded && getenv("PROFILER_BASELINE") != NULL) {
+		loadBaseline(getenv("PROFILER_BASELINE"));
+	}
+	if (baselineLoaded && status == 0) {
+		status = writeDiff(reportName == "-" ? std::string(baseName) : reportName);
+	}
+
+#ifdef _MSC_VER
+	if ((reportFormats & REPORT_HTML) && reportName != "-") {
+		ShellExecuteA(NULL, "open", (reportName + ".html").c_str(), NULL, NULL, SW_SHOW);
+	}
+#endif
+	return status;
+}
+
+void Profiler::mergeShards() {
+	std::lock_guard<std::mutex> lock(shardLock);
+	for (size_t i = 0; i < shards.size(); ++i) {
+		OpcountMap::const_iterator oit;
+		OpcountSequence::const_iterator sit;
+		for (oit = shards[i]->opcountMap.begin(); oit != shards[i]->opcountMap.end(); ++oit) {
+			OpcountSequence& merged = opcountMap[oit->first];
+			for (sit = oit->second.begin(); sit != oit->second.end(); ++sit) {
+				merged[sit->first] += sit->second;
+			}
+		}
+		TimeMap::const_iterator tit;
+		TimeSequence::const_iterator rit;
+		for (tit = shards[i]->timeMap.begin(); tit != shards[i]->timeMap.end(); ++tit) {
+			TimeSequence& merged = timeMap[tit->first];
+			for (rit = tit->second.begin(); rit != tit->second.end(); ++rit) {
+				merged[rit->first].insert(merged[rit->first].end(), rit->second.begin(), rit->second.end());
+			}
+		}
+		for (size_t op = 0; op < shards[i]->flatSeries.size(); ++op) {
+			FlatSeries& series = shards[i]->flatSeries[op];
+			for (size_t bucket = 0; bucket < series.values.size(); ++bucket) {
+				if (series.touched[bucket]) {
+					opcountMap[registered[op].name][(SIZE_MEASURE)bucket * series.bucketWidth] += series.values[bucket];
+				}
+			}
+			std::fill(series.values.begin(), series.values.end(), 0);
+			std::fill(series.touched.begin(), series.touched.end(), 0);
+		}
+		for (size_t event = 0; event < shards[i]->traceEvents.size(); ++event) {
+			shards[i]->traceEvents[event].thread = shards[i]->thread;
+			traceEvents.push_back(shards[i]->traceEvents[event]);
+		}
+		shards[i]->opcountMap.clear();
+		shards[i]->timeMap.clear();
+		shards[i]->traceEvents.clear();
+		std::map<TimerKey, Histogram>::const_iterator hit;
+		for (hit = shards[i]->histograms.begin(); hit != shards[i]->histograms.end(); ++hit) {
+			histograms[hit->first].merge(hit->second);
+		}
+		shards[i]->histograms.clear();
+	}
+}
+
+void Profiler::growFlatSeries(CounterShard& shard, OperationId op, SIZE_MEASURE size) {
+	std::lock_guard<std::mutex> lock(shardLock);
+	if (op.index < 0 || op.index >= (int)registered.size() || size < 0) {
+		throw "unregistered operation or negative size";
+	}
+	while (shard.flatSeries.size() <= (size_t)op.index) {
+		FlatSeries series;
+		series.bucketWidth = registered[shard.flatSeries.size()].bucketWidth;
+		shard.flatSeries.push_back(series);
+	}
+	FlatSeries& series = shard.flatSeries[op.index];
+	size_t buckets = (size_t)(size / series.bucketWidth) + 1;
+	if (buckets > series.values.size()) {
+		buckets = std::max(buckets, 2 * series.values.size());
+		series.values.resize(buckets, 0);
+		series.touched.resize(buckets, 0);
+	}
+}
+
+bool Profiler::openHardwareCounters(CounterShard& shard) {
+	bool available = false;
+	shard.hwOpened = true;
+#ifdef PROFILER_HAS_PERF
+	static const unsigned long long cacheMiss =
+		(PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	static const unsigned int types[HW_EVENT_COUNT] = {
+		PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+		PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE
+	};
+	static const unsigned long long configs[HW_EVENT_COUNT] = {
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_L1D | cacheMiss,
+		PERF_COUNT_HW_CACHE_LL | cacheMiss, PERF_COUNT_HW_CACHE_DTLB | cacheMiss, PERF_COUNT_HW_BRANCH_MISSES
+	};
+	for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+		if (shard.hwEventFd[i] >= 0) {
+			available = true;
+			continue;
+		}
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[i];
+		attr.config = configs[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		shard.hwEventFd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+		available = available || shard.hwEventFd[i] >= 0;
+	}
+#endif
+	return available;
+}
+
+void Profiler::closeHardwareCounters(CounterShard& shard) {
+	for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+#ifdef PROFILER_HAS_PERF
+		if (shard.hwEventFd[i] >= 0) {
+			close(shard.hwEventFd[i]);
+		}
+#endif
+		shard.hwEventFd[i] = -1;
+	}
+	shard.hwOpened = false;
+	shard.runningHwCounters.clear();
+}
+
+static std::mutex& LiveProfilersLock() {
+	static std::mutex lock;
+	return lock;
+}
+
+static std::vector<Profiler*>& LiveProfilers() {
+	static std::vector<Profiler*> profilers;
+	return profilers;
+}
+
+void Profiler::addLiveProfiler(Profiler* profiler) {
+	std::lock_guard<std::mutex> lock(LiveProfilersLock());
+	LiveProfilers().push_back(profiler);
+}
+
+void Profiler::removeLiveProfiler(Profiler* profiler) {
+	std::lock_guard<std::mutex> lock(LiveProfilersLock());
+	std::vector<Profiler*>& profilers = LiveProfilers();
+	profilers.erase(std::remove(profilers.begin(), profilers.end(), profiler), profilers.end());
+}
+
+void Profiler::releaseLocalShard() {
+	std::lock_guard<std::mutex> lock(shardLock);
+	unsigned long long self = ThreadToken();
+	for (size_t i = 0; i < shards.size(); ++i) {
+		if (shards[i]->owner == self) {
+			closeHardwareCounters(*shards[i]);
+			shards[i]->runningTimers.clear();
+			shards[i]->runningAllocations.clear();
+			shards[i]->openTraces.clear();
+			shards[i]->owner = 0;
+		}
+	}
+}
+
+void ReleaseThreadCounters() {
+	std::lock_guard<std::mutex> lock(LiveProfilersLock());
+	std::vector<Profiler*>& profilers = LiveProfilers();
+	for (size_t i = 0; i < profilers.size(); ++i) {
+		profilers[i]->releaseLocalShard();
+	}
+}
+
+void Profiler::readHardwareCounters(const CounterShard& shard, HwReading& reading) {
+	for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+		unsigned long long buffer[3] = { 0, 0, 0 };
+#ifdef PROFILER_HAS_PERF
+		if (shard.hwEventFd[i] >= 0 && read(shard.hwEventFd[i], buffer, sizeof(buffer)) != sizeof(buffer)) {
+			buffer[0] = buffer[1] = buffer[2] = 0;
+		}
+#endif
+		reading.value[i] = buffer[0];
+		reading.enabled[i] = buffer[1];
+		reading.running[i] = buffer[2];
+	}
+}
+
+const char* Profiler::hwEventSuffix(int event) {
+	switch (event) {
+	case HW_CYCLES: return " hw cycles";
+	case HW_INSTRUCTIONS: return " instructions";
+	case HW_L1D_MISSES: return " L1D misses";
+	case HW_LLC_MISSES: return " LLC misses";
+	case HW_DTLB_MISSES: return " dTLB misses";
+	default: return " branch misses";
+	}
+}
+
+const char* Profiler::timeStatSuffix(int stat) {
+	switch (stat) {
+	case TIME_MIN: return " min";
+	case TIME_MEAN: return " mean";
+	case TIME_P95: return " p95";
+	case TIME_CYCLES: return " cycles";
+	default: return "";
+	}
+}
+
+double Profiler::timeStatistic(const std::vector<TimeSample>& runs, int stat) {
+	size_t i;
+	double sum = 0;
+	std::vector<double> values(runs.size());
+	for (i = 0; i < runs.size(); ++i) {
+		values[i] = stat == TIME_CYCLES ? runs[i].cycles : runs[i].nanoseconds;
+		sum += values[i];
+	}
+	std::sort(values.begin(), values.end());
+	if (stat == TIME_MIN) {
+		return values.front();
+	}
+	if (stat == TIME_MEAN) {
+		return sum / values.size();
+	}
+	return quantile(values, stat == TIME_P95 ? 0.95 : 0.5);
+}
+
+double Profiler::quantile(const std::vector<double>& sorted, double q) {
+	double position = q * (sorted.size() - 1);
+	size_t below = (size_t)position;
+	if (below + 1 >= sorted.size()) {
+		return sorted.back();
+	}
+	return sorted[below] + (position - below) * (sorted[below + 1] - sorted[below]);
+}
+
+std::vector<double> Profiler::withoutOutliers(std::vector<double> values) {
+	std::vector<double> kept;
+	std::sort(values.begin(), values.end());
+	if (values.empty()) {
+		return kept;
+	}
+	double q1 = quantile(values, 0.25), q3 = quantile(values, 0.75);
+	double low = q1 - 1.5 * (q3 - q1), high = q3 + 1.5 * (q3 - q1);
+	for (size_t i = 0; i < values.size(); ++i) {
+		if (values[i] >= low && values[i] <= high) {
+			kept.push_back(values[i]);
+		}
+	}
+	return kept;
+}
+
+int Profiler::writeDiff(const std::string& reportName) {
+	FILE* fout = NULL;
+	bool regressed = false;
+#ifdef _MSC_VER
+	fopen_s(&fout, (reportName + "-diff.csv").c_str(), "wb");
+#else
+	fout = fopen((reportName + "-diff.csv").c_str(), "wb");
+#endif
+	if (fout == NULL) {
+		return -1;
+	}
+	{
+		ReportWriter out(fout);
+		out.text("section,series,size,baseline,current,change,status\n");
+		for (OpcountMap::const_iterator oit = opcountMap.begin(); oit != opcountMap.end(); ++oit) {
+			for (OpcountSequence::const_iterator pit = oit->second.begin(); pit != oit->second.end(); ++pit) {
+				regressed |= writeDiffPoint(out, 0, oit->first, pit->first, (double)pit->second);
+			}
+		}
+		for (TimeMap::const_iterator tit = timeMap.begin(); tit != timeMap.end(); ++tit) {
+			for (TimeSequence::const_iterator pit = tit->second.begin(); pit != tit->second.end(); ++pit) {
+				regressed |= writeDiffPoint(out, 1, tit->first, pit->first, timeStatistic(pit->second, TIME_MEDIAN));
+			}
+		}
+	}
+	fclose(fout);
+	regressionFound = regressionFound || regressed;
+	return regressed ? 1 : 0;
+}
 
-#define _CRT_SECURE_NO_DEPRECATE
-#define _CRT_SECURE_NO_WARNINGS
+bool Profiler::writeDiffPoint(ReportWriter& out, int section, const std::string& name, SIZE_MEASURE size, double current) {
+	const BaselineMap& baseline = section == 0 ? baselineOpcount : baselineTimes;
+	BaselineMap::const_iterator sit = baseline.find(name);
+	if (sit == baseline.end() || sit->second.find(size) == sit->second.end()) {
+		return false;
+	}
+	double base = sit->second.find(size)->second;
+	double change = base != 0 ? (current - base) / base : (current != 0 ? 1 : 0);
+	bool regressed = change > regressionThreshold[section];
+	out.text(section == 0 ? "opcount," : "times,");
+	writeCsvName(out, name);
+	out.character(',');
+	out.number(size);
+	out.character(',');
+	out.number(base);
+	out.character(',');
+	out.number(current);
+	out.character(',');
+	out.number(change, 4);
+	out.text(regressed ? ",regression\n" : change < -regressionThreshold[section] ? ",improvement\n" : ",same\n");
+	if (regressed) {
+		fprintf(stderr, "regression: %s \"%s\" at %lld: %.1f -> %.1f (%+.1f%%)\n",
+			section == 0 ? "opcount" : "times", name.c_str(), size, base, current, 100 * change);
+	}
+	return regressed;
+}
 
+void Profiler::addHistogramSeries() {
+	static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	static const char* suffixes[] = { " p50", " p90", " p99", " p99.9", " max" };
+	std::map<TimerKey, Histogram>::const_iterator it;
+	for (it = histograms.begin(); it != histograms.end(); ++it) {
+		const std::string& name = it->first.first;
+		for (int i = 0; i < 5; ++i) {
+			OPCOUNT_MEASURE value = i < 4 ? it->second.percentile(quantiles[i]) : it->second.maximum();
+			opcountMap[name + suffixes[i]][it->first.second] = value;
+		}
+		if (groups.find(name + " percentiles") == groups.end()) {
+			std::vector<std::string>& group = groups[name + " percentiles"];
+			for (int i = 0; i < 5; ++i) {
+				group.push_back(name + suffixes[i]);
+			}
+		}
+	}
+}
+
+int Profiler::writeReport(const std::string& name, int format) {
+	FILE* fout = NULL;
+	const char* extension = format == REPORT_HTML ? ".html" : format == REPORT_JSON ? ".json" : format == REPORT_TRACE ? ".trace.json" : ".csv";
+	if (name == "-") {
+		fout = stdout;
+	}
+	else {
 #ifdef _MSC_VER
-#   include <Windows.h>
-#   include <Shellapi.h>
+		fopen_s(&fout, (name + extension).c_str(), "wb");
+#else
+		fout = fopen((name + extension).c_str(), "wb");
 #endif
+	}
+	if (fout == NULL) {
+		return -1;
+	}
+	{
+		ReportWriter out(fout);
+		if (format == REPORT_CSV) {
+			writeCsv(out);
+		}
+		else if (format == REPORT_TRACE) {
+			writeTrace(out);
+		}
+		else if (format == REPORT_JSON) {
+			writeJson(out, false);
+		}
+		else {
+			out.write(HtmlGen::htmlFirst, HtmlGen::htmlFirstSize);
+			writeJson(out, true);
+			out.write(HtmlGen::htmlLast, HtmlGen::htmlLastSize);
+		}
+	}
+	if (fout == stdout) {
+		fflush(fout);
+		return 0;
+	}
+	return fclose(fout) == 0 ? 0 : -1;
+}
+
+void Profiler::writeTrace(ReportWriter& out) {
+	out.text("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+	out.text("\t{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": ");
+	out.number(id);
+	out.text(", \"tid\": 0, \"args\": {\"name\": ");
+	writeJsonName(out, title, false);
+	out.text("}}");
+	for (size_t i = 0; i < shards.size(); ++i) {
+		out.text(",\n\t{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": ");
+		out.number(id);
+		out.text(", \"tid\": ");
+		out.number((long long)shards[i]->thread);
+		out.text(", \"args\": {\"name\": \"");
+		if (shards[i]->owner == mainThread) {
+			out.text("main");
+		}
+		else {
+			out.text("worker ");
+			out.number((long long)shards[i]->thread);
+		}
+		out.text("\"}}");
+	}
+	for (size_t i = 0; i < traceEvents.size(); ++i) {
+		out.text(",\n\t{\"name\": ");
+		writeJsonName(out, traceEvents[i].name, false);
+		out.text(", \"cat\": \"profiler\", \"ph\": \"X\", \"pid\": ");
+		out.number(id);
+		out.text(", \"tid\": ");
+		out.number((long long)traceEvents[i].thread);
+		out.text(", \"ts\": ");
+		out.number(traceEvents[i].start, 3);
+		out.text(", \"dur\": ");
+		out.number(traceEvents[i].duration, 3);
+		out.character('}');
+	}
+	out.text("\n]}\n");
+}
+
+void Profiler::writeJson(ReportWriter& out, bool identifiers) {
+	const char* separator = "\n";
+
+	//first, show the operation counters
+	out.text("{\n\t\"opcount\": {");
+	OpcountMap::const_iterator oit1;
+	OpcountSequence::const_iterator oit2;
+	for (oit1 = opcountMap.begin(); oit1 != opcountMap.end(); ++oit1) {
+		out.text(separator);
+		out.text("\t\t");
+		writeJsonName(out, oit1->first, identifiers);
+		out.text(": [");
+		for (oit2 = oit1->second.begin(); oit2 != oit1->second.end(); ++oit2) {
+			out.text(oit2 == oit1->second.begin() ? "[" : ", [");
+			out.number(oit2->first);
+			out.text(", ");
+			out.value(oit2->second);
+			out.character(']');
+		}
+		out.character(']');
+		separator = ",\n";
+	}
 
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include <time.h>
+	//then the execution times, the median run in nanoseconds is the main series
+	out.text("\n\t},\n\t\"times\": {");
+	separator = "\n";
+	TimeMap::const_iterator tit1;
+	TimeSequence::const_iterator tit2;
+	for (tit1 = timeMap.begin(); tit1 != timeMap.end(); ++tit1) {
+		for (int stat = 0; stat < TIME_STAT_COUNT; ++stat) {
+			out.text(separator);
+			out.text("\t\t");
+			writeJsonName(out, tit1->first + timeStatSuffix(stat), identifiers);
+			out.text(": [");
+			for (tit2 = tit1->second.begin(); tit2 != tit1->second.end(); ++tit2) {
+				out.text(tit2 == tit1->second.begin() ? "[" : ", [");
+				out.number(tit2->first);
+				out.text(", ");
+				out.number(timeStatistic(tit2->second, stat));
+				out.character(']');
+			}
+			out.character(']');
+			separator = ",\n";
+		}
+	}
+
+	//next show the groups
+	out.text("\n\t},\n\t\"groups\": {");
+	separator = "\n";
+	GroupMap::const_iterator git1;
+	std::vector<std::string>::const_iterator git2;
+	for (git1 = groups.begin(); git1 != groups.end(); ++git1) {
+		out.text(separator);
+		out.text("\t\t");
+		writeJsonName(out, git1->first, identifiers);
+		out.text(": [");
+		for (git2 = git1->second.begin(); git2 != git1->second.end(); ++git2) {
+			if (git2 != git1->second.begin()) {
+				out.text(", ");
+			}
+			writeJsonName(out, *git2, identifiers);
+		}
+		out.character(']');
+		separator = ",\n";
+	}
+	//every timed operation also gets its min/median/mean/p95 chart
+	for (tit1 = timeMap.begin(); tit1 != timeMap.end(); ++tit1) {
+		if (groups.find(tit1->first + " ns") != groups.end()) {
+			continue;
+		}
+		out.text(separator);
+		out.text("\t\t");
+		writeJsonName(out, tit1->first + " ns", identifiers);
+		out.text(": [");
+		for (int stat = TIME_MIN; stat <= TIME_P95; ++stat) {
+			writeJsonName(out, tit1->first + timeStatSuffix(stat), identifiers);
+			if (stat < TIME_P95) {
+				out.text(", ");
+			}
+		}
+		out.character(']');
+		separator = ",\n";
+	}
+	out.text("\n\t},\n\t\"seed\": ");
+	out.number(GetRandomSeed());
 
-#include <typeinfo>
-#include <map>
-#include <vector>
-#include <algorithm>
-#include <functional>
-#include <string>
+	//last, the complexity model that fits every series best
+	out.text(",\n\t\"fits\": {\n\t\t\"opcount\": {");
+	separator = "\n";
+	for (oit1 = opcountMap.begin(); oit1 != opcountMap.end(); ++oit1) {
+		ComplexityFit fit = fitComplexity(oit1->first.c_str());
+		if (fit.model != NULL) {
+			out.text(separator);
+			writeJsonFit(out, oit1->first, fit, identifiers);
+			separator = ",\n";
+		}
+	}
+	out.text("\n\t\t},\n\t\t\"times\": {");
+	separator = "\n";
+	for (tit1 = timeMap.begin(); tit1 != timeMap.end(); ++tit1) {
+		ComplexityFit fit = fitTimes(tit1->first, tit1->second);
+		if (fit.model != NULL) {
+			out.text(separator);
+			writeJsonFit(out, tit1->first, fit, identifiers);
+			separator = ",\n";
+		}
+	}
+	out.text("\n\t\t}\n\t}\n}\n");
+}
+
+void Profiler::writeCsv(ReportWriter& out) {
+	out.text("section,series,size,value\nmeta,\"seed\",,");
+	out.number(GetRandomSeed());
+	out.character('\n');
+	OpcountMap::const_iterator oit1;
+	OpcountSequence::const_iterator oit2;
+	for (oit1 = opcountMap.begin(); oit1 != opcountMap.end(); ++oit1) {
+		for (oit2 = oit1->second.begin(); oit2 != oit1->second.end(); ++oit2) {
+			out.text("opcount,");
+			writeCsvName(out, oit1->first);
+			out.character(',');
+			out.number(oit2->first);
+			out.character(',');
+			out.value(oit2->second);
+			out.character('\n');
+		}
+	}
+	TimeMap::const_iterator tit1;
+	TimeSequence::const_iterator tit2;
+	for (tit1 = timeMap.begin(); tit1 != timeMap.end(); ++tit1) {
+		for (int stat = 0; stat < TIME_STAT_COUNT; ++stat) {
+			std::string name = tit1->first + timeStatSuffix(stat);
+			for (tit2 = tit1->second.begin(); tit2 != tit1->second.end(); ++tit2) {
+				out.text("times,");
+				writeCsvName(out, name);
+				out.character(',');
+				out.number(tit2->first);
+				out.character(',');
+				out.number(timeStatistic(tit2->second, stat));
+				out.character('\n');
+			}
+		}
+	}
+	//the fitted models, with the model in the size column: fit holds the constant, fit r2 the R^2
+	for (oit1 = opcountMap.begin(); oit1 != opcountMap.end(); ++oit1) {
+		writeCsvFit(out, "opcount", oit1->first, fitComplexity(oit1->first.c_str()));
+	}
+	for (tit1 = timeMap.begin(); tit1 != timeMap.end(); ++tit1) {
+		writeCsvFit(out, "times", tit1->first, fitTimes(tit1->first, tit1->second));
+	}
+}
+
+void Profiler::writeJsonFit(ReportWriter& out, const std::string& name, const ComplexityFit& fit, bool identifiers) {
+	out.text("\t\t\t");
+	writeJsonName(out, name, identifiers);
+	out.text(": {\"model\": \"");
+	out.text(fit.model);
+	out.text("\", \"constant\": ");
+	out.number(fit.constant, 6);
+	out.text(", \"r2\": ");
+	out.number(fit.r2, 6);
+	out.character('}');
+}
+
+void Profiler::writeCsvFit(ReportWriter& out, const char* section, const std::string& name, const ComplexityFit& fit) {
+	if (fit.model == NULL) {
+		return;
+	}
+	for (int row = 0; row < 2; ++row) {
+		out.text(row == 0 ? "fit," : "fit r2,");
+		writeCsvName(out, std::string(section) + " " + name);
+		out.text(",\"");
+		out.text(fit.model);
+		out.text("\",");
+		out.number(row == 0 ? fit.constant : fit.r2, 6);
+		out.character('\n');
+	}
+}
+
+Profiler::ComplexityFit Profiler::fitTimes(const std::string& name, const TimeSequence& sequence) {
+	std::vector<std::pair<double, double> > points;
+	for (TimeSequence::const_iterator it = sequence.begin(); it != sequence.end(); ++it) {
+		points.push_back(std::make_pair((double)it->first, timeStatistic(it->second, TIME_MEDIAN)));
+	}
+	return fitPoints(name, points);
+}
+
+Profiler::ComplexityFit Profiler::fitPoints(const std::string& name, const std::vector<std::pair<double, double> >& points) {
+	static const char* modelNames[MODEL_COUNT] = { "1", "log n", "n", "n log n", "n^2", "n log k" };
+	ComplexityFit best = { NULL, 0, 0 };
+	std::map<std::string, std::pair<char, SIZE_MEASURE> >::const_iterator fixed = fixedSizes.find(name);
+	double mean = 0, total = 0;
+	size_t i;
+
+	if (points.size() < 3) {
+		return best;
+	}
+	for (i = 0; i < points.size(); ++i) {
+		mean += points[i].second;
+	}
+	mean /= points.size();
+	for (i = 0; i < points.size(); ++i) {
+		total += (points[i].second - mean) * (points[i].second - mean);
+	}
+	for (int model = 0; model < MODEL_COUNT; ++model) {
+		if (model == MODEL_N_LOG_K && fixed == fixedSizes.end()) {
+			continue;
+		}
+		double fy = 0, ff = 0, residual = 0;
+		for (i = 0; i < points.size(); ++i) {
+			double f = complexityModel(model, points[i].first, fixed == fixedSizes.end() ? NULL : &fixed->second);
+			fy += f * points[i].second;
+			ff += f * f;
+		}
+		if (ff == 0) {
+			continue;
+		}
+		double constant = fy / ff;
+		for (i = 0; i < points.size(); ++i) {
+			double f = complexityModel(model, points[i].first, fixed == fixedSizes.end() ? NULL : &fixed->second);
+			residual += (points[i].second - constant * f) * (points[i].second - constant * f);
+		}
+		double r2 = total == 0 ? (residual == 0 ? 1 : 0) : 1 - residual / total;
+		//n log k is only a rescaled log n or n, so it wins the ties once declared
+		if (best.model == NULL || r2 > best.r2 || (model == MODEL_N_LOG_K && r2 >= best.r2 - 1e-9)) {
+			best.model = modelNames[model];
+			best.constant = constant;
+			best.r2 = r2;
+		}
+	}
+	return best;
+}
+
+double Profiler::complexityModel(int model, double x, const std::pair<char, SIZE_MEASURE>* fixed) {
+	double logX = x > 1 ? log2(x) : 0;
+	switch (model) {
+	case MODEL_CONSTANT: return 1;
+	case MODEL_LOG: return logX;
+	case MODEL_LINEAR: return x;
+	case MODEL_N_LOG_N: return x * logX;
+	case MODEL_QUADRATIC: return x * x;
+	default:
+		//x is k when n is the fixed size, and n otherwise
+		return fixed->first == 'n' ? fixed->second * logX : x * log2((double)fixed->second);
+	}
+}
+
+void Profiler::writeJsonName(ReportWriter& out, const std::string& name, bool identifier) {
+	out.character('"');
+	if (identifier) {
+		print_modified(out, name.c_str());
+	}
+	else {
+		for (size_t i = 0; i < name.size(); ++i) {
+			unsigned char c = (unsigned char)name[i];
+			if (c == '"' || c == '\\') {
+				out.character('\\');
+				out.character((char)c);
+			}
+			else if (c < 0x20) {
+				static const char hex[] = "0123456789abcdef";
+				out.text("\\u00");
+				out.character(hex[c >> 4]);
+				out.character(hex[c & 15]);
+			}
+			else {
+				out.character((char)c);
+			}
+		}
+	}
+	out.character('"');
+}
+
+void Profiler::writeCsvName(ReportWriter& out, const std::string& name) {
+	out.character('"');
+	for (size_t i = 0; i < name.size(); ++i) {
+		if (name[i] == '"') {
+			out.character('"');
+		}
+		out.character(name[i]);
+	}
+	out.character('"');
+}
+
+void Profiler::print_modified(ReportWriter& out, const char* str) {
+	int i = 0;
+	while (str[i] != 0) {
+		if (isalnum((unsigned char)str[i]) || str[i] == '_') {
+			out.character(str[i]);
+		}
+		else {
+			out.character('_');
+		}
+		++i;
+	}
+}
 
 namespace HtmlGen {
 	const char htmlFirst[] = {
@@ -10961,6 +12081,7 @@ namespace HtmlGen {
 	0x65, 0x63, 0x75, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x73, 0x22, 0x0a, 0x7d,
 	0x0a, 0x0a, 0x76, 0x61, 0x72, 0x20, 0x64, 0x61, 0x74, 0x61, 0x20, 0x3d, 0x20
 	};
+	const size_t htmlFirstSize = sizeof(htmlFirst);
 
 	const char htmlLast[] = {
 	0x0a, 0x09, 0x76, 0x61, 0x72, 0x20, 0x62, 0x6f, 0x64, 0x79, 0x20, 0x3d, 0x20, 0x24, 0x28, 0x27,
@@ -11091,347 +12212,5 @@ namespace HtmlGen {
 	0x2f, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x3e, 0x0a, 0x0a, 0x20, 0x3c, 0x2f, 0x62, 0x6f, 0x64,
 	0x79, 0x3e, 0x0a, 0x3c, 0x2f, 0x68, 0x74, 0x6d, 0x6c, 0x3e, 0x0a
 	};
-};
-
-class Profiler {
-public:
-	/**
-	* maximum lenght for any string that this class should receive
-	*/
-	static const int MAX_NAME_LEN = 128;
-
-	/**
-	* constructs a new profiler with the given title
-	*/
-	Profiler(const char* givenTitle = NULL) {
-		reset(givenTitle);
-	}
-
-	~Profiler() {
-	}
-
-	/**
-	* increases the count for operation name, at the specified size
-	*/
-	void reset(const char* newTitle = NULL) {
-		if (opcountMap.size() != 0) {
-			showReport();
-		}
-		title = newTitle ? newTitle : "Title";
-		groups.clear();
-		opcountMap.clear();
-	}
-
-	/**
-	* increases the count for operation name, at the specified size
-	*/
-	void countOperation(const char* name, int size, int increment = 1) {
-		opcountMap[name][size] += increment;
-	}
-
-	/**
-	* creates a new group from the given members
-	* the members will be displayed in the same chart
-	*/
-	void createGroup(const char* groupName, const char* member1, const char* member2 = NULL,
-		const char* member3 = NULL, const char* member4 = NULL,
-		const char* member5 = NULL, const char* member6 = NULL,
-		const char* member7 = NULL, const char* member8 = NULL,
-		const char* member9 = NULL, const char* member10 = NULL) {
-		groups[groupName] = std::vector<std::string>();
-		//this is a bad coding style
-		//kids, don't do this at home
-#define ADD_MEMBER(member) if(member) {groups[groupName].push_back(member);}
-		ADD_MEMBER(member1);
-		ADD_MEMBER(member2);
-		ADD_MEMBER(member3);
-		ADD_MEMBER(member4);
-		ADD_MEMBER(member5);
-		ADD_MEMBER(member6);
-		ADD_MEMBER(member7);
-		ADD_MEMBER(member8);
-		ADD_MEMBER(member9);
-		ADD_MEMBER(member10);
-#undef ADD_MEMBER
-	}
-
-	/**
-	* creates a new series, by summing the given ones
-	*/
-	void addSeries(const char* newName, const char* series1, const char* series2) {
-		if (opcountMap.find(series1) != opcountMap.end() &&
-			opcountMap.find(series2) != opcountMap.end()) {
-			OpcountSequence::const_iterator it1, it2;
-			opcountMap[newName] = OpcountSequence();
-			for (it1 = opcountMap[series1].begin(); it1 != opcountMap[series1].end(); ++it1) {
-				it2 = opcountMap[series2].find(it1->first);
-				if (it2 != opcountMap[series2].end()) {
-					opcountMap[newName][it1->first] = it1->second + it2->second;
-				}
-				else {
-					opcountMap[newName][it1->first] = it1->second;
-				}
-			}
-		}
-	}
-
-	/**
-	* divides the values in a series
-	*/
-	void divideValues(const char* series, unsigned int divisor) {
-		if (opcountMap.find(series) != opcountMap.end() && divisor != 0) {
-			OpcountSequence::iterator it;
-			for (it = opcountMap[series].begin(); it != opcountMap[series].end(); ++it) {
-				it->second /= divisor;
-			}
-		}
-	}
-
-	/**
-	* creates and shows the report
-	*/
-	int showReport() {
-		FILE* fout = NULL;
-		bool hasData, hasSequences;
-		char reportName[200];
-		time_t crtTime = time(0);
-		struct tm now;
-#ifdef _MSC_VER
-		localtime_s(&now, &crtTime);
-#else
-		now = *localtime(&crtTime);
-#endif
-
-#ifdef _MSC_VER
-		_snprintf_s(
-#else
-		snprintf(
-#endif
-			reportName, sizeof(reportName),
-			"report-%s-%04d%02d%02d-%02d%02d%02d.html",
-			title.c_str(),
-			now.tm_year + 1900,
-			now.tm_mon + 1,
-			now.tm_mday,
-			now.tm_hour,
-			now.tm_min,
-			now.tm_sec
-		);
-#ifdef _MSC_VER
-		fopen_s(&fout, reportName, "wb");
-#else
-		fout = fopen(reportName, "wb");
-#endif
-		fwrite(HtmlGen::htmlFirst, 1, sizeof(HtmlGen::htmlFirst) / sizeof(HtmlGen::htmlFirst[0]), fout);
-
-		//first, show the operation counters
-		fprintf(fout, "{\n\t\"opcount\": {\n");
-		OpcountMap::const_iterator oit1;
-		OpcountSequence::const_iterator oit2;
-		hasSequences = false;
-		for (oit1 = opcountMap.begin(); oit1 != opcountMap.end(); ++oit1) {
-			hasSequences = true;
-			hasData = false;
-			fprintf(fout, "\t\t\"");
-			print_modified(fout, oit1->first.c_str());
-			fprintf(fout, "\": [");
-			for (oit2 = oit1->second.begin(); oit2 != oit1->second.end(); ++oit2) {
-				hasData = true;
-				fprintf(fout, "[%d, %u], ", oit2->first, oit2->second);
-			}
-			if (hasData) {
-				fseek(fout, -2, SEEK_CUR);
-			}
-			fprintf(fout, "],\n");
-		}
-		if (hasSequences) {
-			fseek(fout, -(int)(strlen("\n") + 1), SEEK_CUR);
-			fprintf(fout, "\n");
-		}
-
-		fprintf(fout, "\t},\n\t\"groups\": {\n");
-		//next show the groups
-		hasSequences = false;
-		GroupMap::const_iterator git1;
-		std::vector<std::string>::const_iterator git2;
-		for (git1 = groups.begin(); git1 != groups.end(); ++git1) {
-			hasSequences = true;
-			hasData = false;
-			fprintf(fout, "\t\t\"");
-			print_modified(fout, git1->first.c_str());
-			fprintf(fout, "\": [");
-			for (git2 = git1->second.begin(); git2 != git1->second.end(); ++git2) {
-				hasData = true;
-				fprintf(fout, "\"");
-				print_modified(fout, git2->c_str());
-				fprintf(fout, "\", ");
-			}
-			if (hasData) {
-				fseek(fout, -2, SEEK_CUR);
-			}
-			fprintf(fout, "],\n");
-		}
-		if (hasSequences) {
-			fseek(fout, -(int)(strlen("\n") + 1), SEEK_CUR);
-			fprintf(fout, "\n");
-		}
-		fprintf(fout, "\t}\n}\n");
-		fwrite(HtmlGen::htmlLast, 1, sizeof(HtmlGen::htmlLast) / sizeof(HtmlGen::htmlLast[0]), fout);
-		fclose(fout);
-
-#ifdef _MSC_VER
-		ShellExecuteA(NULL, "open", reportName, NULL, NULL, SW_SHOW);
-#endif
-		return 0;
-	}
-
-private:
-	typedef unsigned int OPCOUNT_MEASURE;
-
-	typedef std::map<int, OPCOUNT_MEASURE> OpcountSequence;
-	typedef std::map<std::string, OpcountSequence> OpcountMap;
-
-	typedef std::map<std::string, std::vector<std::string> > GroupMap;
-
-public:
-	class OperationCounter {
-		OpcountSequence::iterator ptrInMap;
-		Profiler& profiler;
-		friend class Profiler;
-		OperationCounter(Profiler& prof, const char* name, int size) : profiler(prof) {
-			profiler.opcountMap[name][size]; // force creation
-			ptrInMap = profiler.opcountMap[name].find(size);
-		}
-	public:
-		void count(int increment = 1) { ptrInMap->second += increment; }
-		int get() const { return ptrInMap->second; }
-	};
-
-	OperationCounter createOperation(const char* name, int size) {
-		return OperationCounter(*this, name, size);
-	}
-
-private:
-	std::string title;
-	OpcountMap opcountMap;
-	GroupMap groups;
-
-	void print_modified(FILE* f, const char* str) {
-		int i = 0;
-		while (str[i] != 0) {
-			if (isalnum(str[i]) || str[i] == '_') {
-				fprintf(f, "%c", str[i]);
-			}
-			else {
-				fprintf(f, "_");
-			}
-			++i;
-		}
-	}
-};
-
-typedef Profiler::OperationCounter Operation;
-
-enum SortMethod { UNSORTED = 0, ASCENDING = 1, DESCENDING = 2 };
-/**
-* fills the given array with random elements in the given range.
-* optionally, the array can be unique or sorted in ascending (1) or descending (2) order
-*/
-template <typename T>
-void FillRandomArray(T* arr, int size, T range_min = 10, T range_max = 50000, bool unique = false, int sorted = UNSORTED) {
-	int i, pos, extendedSize;
-	bool discreteType = true;
-	T interval_len = range_max - range_min + 1;
-	int idx1, idx2;
-	T aux;
-	static bool seeded = false;
-
-	if (!seeded) {
-		srand((unsigned int)time(NULL));
-		seeded = true;
-	}
-
-	if (range_min >= range_max) {
-		throw "empty range";
-	}
-
-	if (typeid(T) == typeid(double) || typeid(T) == typeid(float)) {
-		discreteType = false;
-	}
-	if (!unique) {
-		//no worries
-		for (i = 0; i < size; ++i) {
-			if (discreteType) {
-				arr[i] = range_min + (rand() % int(interval_len));
-			}
-			else {
-				arr[i] = range_min + ((T)(rand()) / RAND_MAX) * (interval_len - 1);
-			}
-		}
-		if (sorted == ASCENDING) {
-			std::sort(arr, arr + size);
-		}
-		else if (sorted == DESCENDING) {
-			std::sort(arr, arr + size, std::greater<T>());
-		}
-	}
-	else {
-		//use Knuth approach
-		if (discreteType) {
-			if (interval_len < size) {
-				throw "range too small";
-			}
-			pos = 0;
-			for (i = 0; i <= interval_len && pos < size; ++i) {
-				if (rand() % (int(interval_len) - i) < (size - pos)) {
-					arr[pos++] = range_min + i;
-				}
-			}
-		}
-		else {
-			//use the same approach as above, pick integers from 0 to 17*size
-			extendedSize = 17 * size;
-			pos = 0;
-			for (i = 0; i <= extendedSize && pos < size; ++i) {
-				if (rand() % (extendedSize - i) < (size - pos)) {
-					arr[pos++] = range_min + ((T)i / extendedSize) * (interval_len - 1);
-				}
-			}
-		}
-		//we got a sorted array in ascending order
-		if (sorted == DESCENDING) {
-			std::reverse(arr, arr + size);
-		}
-		else if (sorted == UNSORTED) {
-			//we need to scramble the array
-			for (i = 0; i < size; ++i) {
-				idx1 = rand() % size;
-				idx2 = rand() % size;
-				aux = arr[idx1];
-				arr[idx1] = arr[idx2];
-				arr[idx2] = aux;
-			}
-		}
-	}
-}
-
-template <typename T>
-void CopyArray(T* dst, T* src, int size) {
-	memcpy(dst, src, size * sizeof(T));
-}
-
-/**
-* Checks if the given array is sorted or not.
-*/
-template <typename T>
-bool IsSorted(T* arr, int size) {
-	int i;
-	for (i = 1; i < size; ++i) {
-		if (arr[i] < arr[i - 1]) {
-			return false;
-		}
-	}
-	return true;
+	const size_t htmlLastSize = sizeof(htmlLast);
 }
-
-#endif
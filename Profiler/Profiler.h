@@ -0,0 +1,1854 @@
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#ifndef _CRT_SECURE_CPP_OVERLOAD_STANDARD_NAMES
+#define _CRT_SECURE_CPP_OVERLOAD_STANDARD_NAMES 1
+#endif
+
+#define _CRT_SECURE_NO_DEPRECATE
+#define _CRT_SECURE_NO_WARNINGS
+
+#ifdef _MSC_VER
+#   ifndef NOMINMAX
+#       define NOMINMAX // keeps std::min/std::max usable
+#   endif
+#   include <Windows.h>
+#   include <Shellapi.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <math.h>
+
+#include <typeinfo>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <exception>
+
+#if defined(_M_IX86) || defined(_M_X64)
+#   include <intrin.h>
+#   define PROFILER_HAS_TSC 1
+#elif defined(__i386__) || defined(__x86_64__)
+#   include <x86intrin.h>
+#   define PROFILER_HAS_TSC 1
+#endif
+
+#if defined(__linux__)
+#   include <unistd.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <linux/perf_event.h>
+#   include <pthread.h>
+#   include <sched.h>
+#   define PROFILER_HAS_PERF 1
+#endif
+
+#if defined(_MSC_VER) || defined(__linux__)
+#   include <malloc.h>
+#elif defined(__APPLE__)
+#   include <malloc/malloc.h>
+#endif
+
+/**
+* the report page around the data, defined once in Profiler.cpp instead
+* of being compiled in every file that includes this header
+*/
+namespace HtmlGen {
+	extern const char htmlFirst[];
+	extern const size_t htmlFirstSize;
+	extern const char htmlLast[];
+	extern const size_t htmlLastSize;
+}
+
+/**
+* xoshiro256** pseudo random generator, seeded through splitmix64
+* much faster than rand(), gives 64 bits per call and the same sequence
+* for the same seed on every platform
+*/
+class RandomGenerator {
+public:
+	RandomGenerator(unsigned long long seed = 0) {
+		setSeed(seed);
+	}
+
+	/**
+	* generator number stream of the family given by seed, streams are
+	* independent of each other and can be created in any order
+	*/
+	RandomGenerator(unsigned long long seed, unsigned long long stream) {
+		unsigned long long mixed = stream;
+		setSeed(seed ^ splitMix(mixed));
+	}
+
+	void setSeed(unsigned long long newSeed) {
+		seed = newSeed;
+		for (int i = 0; i < 4; ++i) {
+			state[i] = splitMix(newSeed);
+		}
+	}
+
+	unsigned long long getSeed() const {
+		return seed;
+	}
+
+	unsigned long long next() {
+		unsigned long long result = rotl(state[1] * 5, 7) * 9;
+		unsigned long long t = state[1] << 17;
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = rotl(state[3], 45);
+		return result;
+	}
+
+	/**
+	* returns a value in [0, bound) without the bias of next() % bound
+	* (Lemire's multiply and reject, the division is only needed rarely)
+	*/
+	unsigned long long nextBelow(unsigned long long bound) {
+		unsigned long long low;
+		unsigned long long high = mulHigh(next(), bound, low);
+		if (low < bound) {
+			unsigned long long threshold = (0 - bound) % bound;
+			while (low < threshold) {
+				high = mulHigh(next(), bound, low);
+			}
+		}
+		return high;
+	}
+
+	/**
+	* returns a value in [0, 1)
+	*/
+	double nextDouble() {
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+private:
+	unsigned long long state[4];
+	unsigned long long seed;
+
+	static unsigned long long splitMix(unsigned long long& x) {
+		unsigned long long z = (x += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	static unsigned long long rotl(unsigned long long x, int k) {
+		return (x << k) | (x >> (64 - k));
+	}
+
+	static unsigned long long mulHigh(unsigned long long a, unsigned long long b, unsigned long long& low) {
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 product = (unsigned __int128)a * b;
+		low = (unsigned long long)product;
+		return (unsigned long long)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		return _umul128(a, b, &low);
+#else
+		unsigned long long aLow = a & 0xFFFFFFFFULL, aHigh = a >> 32;
+		unsigned long long bLow = b & 0xFFFFFFFFULL, bHigh = b >> 32;
+		unsigned long long lowLow = aLow * bLow, highLow = aHigh * bLow;
+		unsigned long long lowHigh = aLow * bHigh, highHigh = aHigh * bHigh;
+		unsigned long long middle = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + lowHigh;
+		low = (middle << 32) | (lowLow & 0xFFFFFFFFULL);
+		return highHigh + (highLow >> 32) + (middle >> 32);
+#endif
+	}
+};
+
+/**
+* holds the seed every other generator is derived from, taken from the clock
+* on first use unless SetRandomSeed is called; the seed is written in every
+* report, so any run can be repeated with the same input
+*/
+inline RandomGenerator& SeedEngine() {
+	static RandomGenerator generator((unsigned long long)std::chrono::system_clock::now().time_since_epoch().count());
+	return generator;
+}
+
+/**
+* a number of its own for the calling thread, never given to another one
+* (std::thread::id values are reused once a thread has ended)
+*/
+inline unsigned long long ThreadToken() {
+	static std::atomic<unsigned long long> lastToken(0);
+	static thread_local unsigned long long token = ++lastToken;
+	return token;
+}
+
+/**
+* bumped by SetRandomSeed, so the thread generators know their seed changed
+*/
+inline std::atomic<unsigned long long>& SeedGeneration() {
+	static std::atomic<unsigned long long> generation(0);
+	return generation;
+}
+
+/**
+* generator of the calling thread outside the sweeps: stream ThreadToken() of
+* the seed, so threads never share a state and a thread draws the same
+* numbers for the same seed
+*/
+inline RandomGenerator& ThreadEngine() {
+	static thread_local RandomGenerator generator;
+	static thread_local unsigned long long generation = ~0ULL;
+	if (generation != SeedGeneration().load(std::memory_order_relaxed)) {
+		generation = SeedGeneration().load();
+		generator = RandomGenerator(SeedEngine().getSeed(), ThreadToken());
+	}
+	return generator;
+}
+
+/**
+* generator of the sweep point running on this thread, see ParallelSweep
+*/
+inline RandomGenerator*& PointEngine() {
+	static thread_local RandomGenerator* generator = NULL;
+	return generator;
+}
+
+inline RandomGenerator& RandomEngine() {
+	return PointEngine() != NULL ? *PointEngine() : ThreadEngine();
+}
+
+/**
+* call before the threads that draw numbers start, SeedEngine is not locked
+*/
+inline void SetRandomSeed(unsigned long long seed) {
+	SeedEngine().setSeed(seed);
+	++SeedGeneration();
+}
+
+inline unsigned long long GetRandomSeed() {
+	return SeedEngine().getSeed();
+}
+
+/**
+* closes the hardware counters the calling thread opened in every profiler and
+* hands its shards over to the threads started later; the threads of
+* ParallelBlocks and ParallelSweep call it before they end
+*/
+void ReleaseThreadCounters();
+
+/**
+* number of threads used to generate the inputs, 0 means one per core
+*/
+inline int& RandomThreadCount() {
+	static int threads = 0;
+	return threads;
+}
+
+inline void SetRandomThreads(int threads) {
+	RandomThreadCount() = threads;
+}
+
+/**
+* elements generated from one random stream, the unit of work of ParallelBlocks
+*/
+static const long long RANDOM_BLOCK_SIZE = 1 << 16;
+
+/**
+* calls function(block, begin, end) for every block of blockSize elements in
+* [0, count), spreading the blocks over the input threads; the blocks do not
+* depend on the number of threads, so a function that draws block b from
+* RandomGenerator(seed, b) gives the same output on any machine
+*/
+template <typename Function>
+void ParallelBlocks(long long count, long long blockSize, Function function) {
+	long long blocks = (count + blockSize - 1) / blockSize;
+	int threads = RandomThreadCount() > 0 ? RandomThreadCount() : (int)std::thread::hardware_concurrency();
+
+	if (PointEngine() != NULL) {
+		threads = 1; // inside a sweep every core already has its own point
+	}
+	std::atomic<long long> nextBlock(0);
+	std::vector<std::thread> workers;
+
+	if (threads > blocks) {
+		threads = (int)blocks;
+	}
+	auto work = [&]() {
+		for (long long block = nextBlock++; block < blocks; block = nextBlock++) {
+			function(block, block * blockSize, std::min(count, (block + 1) * blockSize));
+		}
+	};
+	for (int i = 1; i < threads; ++i) {
+		workers.push_back(std::thread([&]() {
+			work();
+			ReleaseThreadCounters();
+		}));
+	}
+	work();
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+}
+
+/**
+* number of threads used by ParallelSweep, 0 means one per core
+*/
+inline int& SweepThreadCount() {
+	static int threads = 0;
+	return threads;
+}
+
+inline void SetSweepThreads(int threads) {
+	SweepThreadCount() = threads;
+}
+
+/**
+* if set, sweep thread i only runs on core i, so the timed points do not
+* migrate between cores while they run
+*/
+inline bool& SweepPinning() {
+	static bool pinning = false;
+	return pinning;
+}
+
+inline void SetSweepPinning(bool pinning) {
+	SweepPinning() = pinning;
+}
+
+/**
+* binds the calling thread to one core; returns false where this is not supported
+*/
+inline bool PinThread(int core) {
+#if defined(_MSC_VER)
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (core % (8 * sizeof(DWORD_PTR)))) != 0;
+#elif defined(__linux__)
+	cpu_set_t cores;
+	CPU_ZERO(&cores);
+	CPU_SET(core % CPU_SETSIZE, &cores);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+#else
+	return false;
+#endif
+}
+
+/**
+* calls function(size) for size = first, first + step, ... up to last, spreading
+* the points over the sweep threads, largest first; every thread counts into
+* its own shard of the profiler and the shards are merged by the report
+* each point draws its inputs from its own random stream, so the data does
+* not depend on the number of threads or on the order the points run in
+* the function may only share read-only state with the other points:
+* counters it uses must be thread_local; if it throws, the points not started
+* yet are skipped and the first exception is thrown again to the caller
+* throws "bad size range" if step <= 0 or first > last, as the driver does
+*/
+template <typename Function>
+void ParallelSweep(long long first, long long last, long long step, Function function) {
+	if (step <= 0 || first > last) {
+		throw "bad size range";
+	}
+	long long points = (last - first) / step + 1;
+	int threads = SweepThreadCount() > 0 ? SweepThreadCount() : (int)std::thread::hardware_concurrency();
+	unsigned long long sweepSeed = RandomEngine().next();
+	std::atomic<long long> nextPoint(0);
+	std::vector<std::thread> workers;
+	std::exception_ptr failure;
+	std::mutex failureLock;
+
+	if (threads < 1) {
+		threads = 1;
+	}
+	if (threads > points) {
+		threads = (int)points;
+	}
+	auto work = [&](int worker) {
+		if (SweepPinning()) {
+			PinThread(worker);
+		}
+		for (long long point = nextPoint++; point < points; point = nextPoint++) {
+			long long index = points - 1 - point;
+			RandomGenerator generator(sweepSeed, (unsigned long long)index);
+			PointEngine() = &generator;
+			try {
+				function(first + index * step);
+			}
+			catch (...) {
+				//the first failure is thrown again by the calling thread, the points left are skipped
+				std::lock_guard<std::mutex> lock(failureLock);
+				if (!failure) {
+					failure = std::current_exception();
+				}
+				nextPoint = points;
+			}
+			PointEngine() = NULL;
+		}
+		ReleaseThreadCounters();
+	};
+	for (int i = 0; i < threads; ++i) {
+		workers.push_back(std::thread(work, i));
+	}
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+	if (failure) {
+		std::rethrow_exception(failure);
+	}
+}
+
+/**
+* allocations of the calling thread made through the tracked malloc family,
+* see PROFILER_TRACK_ALLOCATIONS at the end of this file; a block freed by
+* another thread than the one that allocated it moves live bytes between them
+*/
+struct AllocationStats {
+	unsigned long long count;
+	unsigned long long bytes;
+	long long live;
+	long long peak;
+};
+
+inline AllocationStats& LocalAllocations() {
+	static thread_local AllocationStats stats = { 0, 0, 0, 0 };
+	return stats;
+}
+
+/**
+* bytes the allocator reserved for block, the same value when the block is
+* allocated and when it is freed; where it cannot be queried the requested
+* size is used and freed blocks are not subtracted
+*/
+inline size_t AllocationSize(void* block, size_t requested) {
+#if defined(_MSC_VER)
+	(void)requested;
+	return _msize(block);
+#elif defined(__linux__)
+	(void)requested;
+	return malloc_usable_size(block);
+#elif defined(__APPLE__)
+	(void)requested;
+	return malloc_size(block);
+#else
+	(void)block;
+	return requested;
+#endif
+}
+
+inline void* NoteAllocation(void* block, size_t requested) {
+	if (block != NULL) {
+		AllocationStats& stats = LocalAllocations();
+		long long bytes = (long long)AllocationSize(block, requested);
+		stats.count++;
+		stats.bytes += bytes;
+		stats.live += bytes;
+		if (stats.live > stats.peak) {
+			stats.peak = stats.live;
+		}
+	}
+	return block;
+}
+
+inline void NoteFree(void* block) {
+	if (block != NULL) {
+		LocalAllocations().live -= (long long)AllocationSize(block, 0);
+	}
+}
+
+inline void* TrackedMalloc(size_t size) {
+	return NoteAllocation(malloc(size), size);
+}
+
+inline void* TrackedCalloc(size_t count, size_t size) {
+	return NoteAllocation(calloc(count, size), count * size);
+}
+
+inline void* TrackedRealloc(void* block, size_t size) {
+	long long old = block != NULL ? (long long)AllocationSize(block, 0) : 0;
+	void* moved = realloc(block, size);
+	if (moved != NULL || size == 0) {
+		LocalAllocations().live -= old;
+	}
+	return NoteAllocation(moved, size);
+}
+
+inline void TrackedFree(void* block) {
+	NoteFree(block);
+	free(block);
+}
+
+class Profiler {
+public:
+	/**
+	* maximum lenght for any string that this class should receive
+	*/
+	static const int MAX_NAME_LEN = 128;
+
+	/**
+	* type of the counted values and of the size axis, both 64 bit so that
+	* quadratic algorithms can be swept to large sizes without overflowing
+	*/
+	typedef unsigned long long OPCOUNT_MEASURE;
+	typedef long long SIZE_MEASURE;
+
+	/**
+	* handle of a series created by registerOperation
+	*/
+	struct OperationId {
+		int index;
+	};
+
+	/**
+	* constructs a new profiler with the given title
+	*/
+	Profiler(const char* givenTitle = NULL) : id(nextProfilerId()), hwEnabled(false), reportFormats(REPORT_HTML),
+		baselineLoaded(false), regressionFound(false), traceOrigin(Clock::now()), mainThread(ThreadToken()) {
+		regressionThreshold[0] = 0.02;
+		regressionThreshold[1] = 0.10;
+		reset(givenTitle);
+		addLiveProfiler(this);
+	}
+
+	~Profiler() {
+		removeLiveProfiler(this);
+		disableHardwareCounters();
+		for (size_t i = 0; i < shards.size(); ++i) {
+			delete shards[i];
+		}
+	}
+
+	/**
+	* shows the report for the current data (if any) and starts over
+	* with the given title
+	*/
+	void reset(const char* newTitle = NULL);
+
+	/**
+	* increases the count for operation name, at the specified size
+	* safe to call from several threads at once, every thread counts in its
+	* own shard and the shards are merged by showReport/reset
+	*/
+	void countOperation(const char* name, SIZE_MEASURE size, OPCOUNT_MEASURE increment = 1) {
+		localShard().opcountMap[name][size] += increment;
+	}
+
+	/**
+	* registers the series name once, so that it can be counted without any
+	* string handling or map lookups; sizes are grouped in buckets of the given
+	* width (e.g. 100 for a 100..10000 step 100 sweep), a bucket being reported
+	* at the size bucket * bucketWidth
+	*/
+	OperationId registerOperation(const char* name, int bucketWidth = 1);
+
+	/**
+	* increases the count for a registered operation, at the specified size
+	*/
+	void countOperation(OperationId op, SIZE_MEASURE size, OPCOUNT_MEASURE increment = 1) {
+		CounterShard& shard = localShard();
+		if (op.index < (int)shard.flatSeries.size()) {
+			FlatSeries& series = shard.flatSeries[op.index];
+			size_t bucket = (size_t)(size / series.bucketWidth);
+			if (bucket < series.values.size()) {
+				series.values[bucket] += increment;
+				series.touched[bucket] = 1;
+				return;
+			}
+		}
+		growFlatSeries(shard, op, size);
+		countOperation(op, size, increment);
+	}
+
+	/**
+	* starts measuring the time for operation name, at the specified size
+	*/
+	void startTimer(const char* name, SIZE_MEASURE size) {
+		TimerStart& start = localShard().runningTimers[TimerKey(name, size)];
+		start.cycles = readCycles();
+		start.time = Clock::now();
+	}
+
+	/**
+	* stops the timer started for operation name, at the specified size
+	* every start/stop pair is kept as a separate run of the same point
+	*/
+	void stopTimer(const char* name, SIZE_MEASURE size) {
+		Clock::time_point stopTime = Clock::now();
+		unsigned long long stopCycles = readCycles();
+		CounterShard& shard = localShard();
+		std::map<TimerKey, TimerStart>::iterator it = shard.runningTimers.find(TimerKey(name, size));
+		if (it == shard.runningTimers.end()) {
+			return;
+		}
+		TimeSample sample;
+		sample.nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stopTime - it->second.time).count();
+		sample.cycles = (double)(stopCycles - it->second.cycles);
+		shard.timeMap[name][size].push_back(sample);
+		shard.runningTimers.erase(it);
+	}
+
+	/**
+	* runs the given function the specified number of times, timing each run
+	* the function should leave its input unchanged (or rebuild it) between runs
+	*/
+	template <typename Function>
+	void measureTime(const char* name, SIZE_MEASURE size, int runs, Function function) {
+		for (int i = 0; i < runs; ++i) {
+			startTimer(name, size);
+			function();
+			stopTimer(name, size);
+		}
+	}
+
+	/**
+	* opens the hardware performance counters (Linux perf_event_open)
+	* other threads open their own counters the first time they use them
+	* returns false if none of them is available, in which case the
+	* start/stop calls below do nothing
+	*/
+	bool enableHardwareCounters() {
+		hwEnabled = true;
+		return openHardwareCounters(localShard());
+	}
+
+	/**
+	* closes the hardware performance counters of every thread
+	*/
+	void disableHardwareCounters() {
+		std::lock_guard<std::mutex> lock(shardLock);
+		hwEnabled = false;
+		for (size_t i = 0; i < shards.size(); ++i) {
+			closeHardwareCounters(*shards[i]);
+		}
+	}
+
+	/**
+	* starts counting hardware events for operation name, at the specified size
+	*/
+	void startHardwareCounters(const char* name, SIZE_MEASURE size) {
+		CounterShard& shard = localShard();
+		if (hwEnabled && !shard.hwOpened) {
+			openHardwareCounters(shard);
+		}
+		readHardwareCounters(shard, shard.runningHwCounters[TimerKey(name, size)]);
+	}
+
+	/**
+	* stops counting hardware events for operation name, at the specified size
+	* the events are added to the series "<name> <event>" (e.g. "<name> L1D misses"),
+	* so repeated runs accumulate just like countOperation
+	*/
+	void stopHardwareCounters(const char* name, SIZE_MEASURE size);
+
+	/**
+	* starts recording the allocations of the calling thread for operation name,
+	* at the specified size; only the code compiled with PROFILER_TRACK_ALLOCATIONS
+	* is seen
+	*/
+	void startAllocations(const char* name, SIZE_MEASURE size) {
+		AllocationStats& stats = LocalAllocations();
+		localShard().runningAllocations[TimerKey(name, size)] = stats;
+		stats.peak = stats.live;
+	}
+
+	/**
+	* stops recording the allocations for operation name, at the specified size
+	* the number of allocations and their bytes are added to "<name> allocations"
+	* and "<name> bytes"; "<name> peak bytes" keeps the highest live bytes above
+	* the ones at the start, over all the runs
+	*/
+	void stopAllocations(const char* name, SIZE_MEASURE size);
+
+	/**
+	* opens a trace region of the calling thread; regions nest and are only
+	* recorded when REPORT_TRACE is one of the report formats
+	*/
+	void beginTrace(const char* name) {
+		if (!(reportFormats & REPORT_TRACE)) {
+			return;
+		}
+		TraceEvent event;
+		event.name = name;
+		event.start = std::chrono::duration<double, std::micro>(Clock::now() - traceOrigin).count();
+		event.duration = 0;
+		localShard().openTraces.push_back(event);
+	}
+
+	/**
+	* closes the innermost trace region of the calling thread
+	*/
+	void endTrace() {
+		CounterShard& shard = localShard();
+		if (shard.openTraces.empty()) {
+			return;
+		}
+		TraceEvent event = shard.openTraces.back();
+		shard.openTraces.pop_back();
+		event.duration = std::chrono::duration<double, std::micro>(Clock::now() - traceOrigin).count() - event.start;
+		shard.traceEvents.push_back(event);
+	}
+
+	/**
+	* divides all the hardware event series of operation name
+	*/
+	void divideHardwareCounters(const char* name, OPCOUNT_MEASURE divisor);
+
+	/**
+	* creates a new group from the given members
+	* the members will be displayed in the same chart
+	*/
+	void createGroup(const char* groupName, const char* member1, const char* member2 = NULL,
+		const char* member3 = NULL, const char* member4 = NULL,
+		const char* member5 = NULL, const char* member6 = NULL,
+		const char* member7 = NULL, const char* member8 = NULL,
+		const char* member9 = NULL, const char* member10 = NULL);
+
+	/**
+	* same as above, for any number of members
+	*/
+	void createGroup(const char* groupName, const std::vector<std::string>& members);
+
+	/**
+	* best model found for a series by fitComplexity: series ~ constant * model(size)
+	* model is NULL when the series has fewer than 3 points
+	*/
+	struct ComplexityFit {
+		const char* model;
+		double constant;
+		double r2;
+	};
+
+	/**
+	* declares the size that stays fixed in a series, so that n log k is among
+	* the models fitted to it: symbol 'k' when the series varies n for a fixed k,
+	* symbol 'n' when it varies k for a fixed n
+	*/
+	void setFixedSize(const char* series, char symbol, SIZE_MEASURE value) {
+		fixedSizes[series] = std::make_pair(symbol, value);
+	}
+
+	/**
+	* fits the operation counts of series against 1, log n, n, n log n, n^2
+	* (and n log k, see setFixedSize) by least squares and returns the model
+	* with the best coefficient of determination
+	*/
+	ComplexityFit fitComplexity(const char* series);
+
+	/**
+	* creates a new series, by summing the given ones
+	*/
+	void addSeries(const char* newName, const char* series1, const char* series2);
+
+	/**
+	* divides the values in a series
+	*/
+	void divideValues(const char* series, OPCOUNT_MEASURE divisor);
+
+	/**
+	* loads the series of a report written with REPORT_JSON as the baseline of
+	* the following reports; several files can be loaded (e.g. one per title)
+	* without a call, showReport loads the file named by PROFILER_BASELINE
+	* returns false if the file cannot be read or parsed
+	*/
+	bool loadBaseline(const char* fileName);
+
+	/**
+	* relative increase over the baseline above which a point is a regression,
+	* separately for the operation counts and for the median times
+	*/
+	void setRegressionThreshold(double opcountThreshold, double timeThreshold) {
+		regressionThreshold[0] = opcountThreshold;
+		regressionThreshold[1] = timeThreshold;
+	}
+
+	/**
+	* true if any report of this profiler had a regression against the baseline
+	*/
+	bool hasRegressions() const {
+		return regressionFound;
+	}
+
+	/**
+	* output formats of showReport, they can be combined (e.g. REPORT_HTML | REPORT_CSV)
+	* REPORT_TRACE writes the trace regions as Chrome trace events (<name>.trace.json),
+	* which chrome://tracing and ui.perfetto.dev open as a timeline
+	*/
+	enum ReportFormat { REPORT_HTML = 1, REPORT_JSON = 2, REPORT_CSV = 4, REPORT_TRACE = 8 };
+
+	/**
+	* selects the formats written by showReport and, optionally, the name used
+	* instead of report-<title>-<time>; the extension of every format is added
+	* to it and the name "-" writes the report to the standard output
+	*/
+	void setReportOutput(int formats, const char* fileName = NULL) {
+		reportFormats = formats;
+		reportFileName = fileName ? fileName : "";
+	}
+
+	/**
+	* creates and shows the report
+	* with a baseline, also writes <report>-diff.csv and lists the regressions on stderr
+	* returns 0 on success, 1 if a series regressed and -1 if a file could not be written
+	*/
+	int showReport();
+
+	/**
+	* distribution of the values of one operation (probes, nanoseconds, ...) in
+	* logarithmic buckets: values below 64 are kept exactly and larger ones in
+	* 32 buckets per power of two, so a percentile is off by at most about 3%
+	*/
+	class Histogram {
+		std::vector<OPCOUNT_MEASURE> buckets;
+		OPCOUNT_MEASURE total;
+		OPCOUNT_MEASURE largest;
+	public:
+		Histogram() : total(0), largest(0) {}
+
+		void record(OPCOUNT_MEASURE value) {
+			size_t index = bucketOf(value);
+			if (index >= buckets.size()) {
+				buckets.resize(index + 1, 0);
+			}
+			buckets[index]++;
+			total++;
+			if (value > largest) {
+				largest = value;
+			}
+		}
+
+		/**
+		* records the nanoseconds taken by function()
+		*/
+		template <typename Function>
+		void time(Function function) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			record((OPCOUNT_MEASURE)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		}
+
+		void merge(const Histogram& other) {
+			if (other.buckets.size() > buckets.size()) {
+				buckets.resize(other.buckets.size(), 0);
+			}
+			for (size_t i = 0; i < other.buckets.size(); ++i) {
+				buckets[i] += other.buckets[i];
+			}
+			total += other.total;
+			largest = std::max(largest, other.largest);
+		}
+
+		OPCOUNT_MEASURE count() const { return total; }
+		OPCOUNT_MEASURE maximum() const { return largest; }
+
+		/**
+		* the value below which a fraction q of the recorded values fall,
+		* reported as the top of its bucket
+		*/
+		OPCOUNT_MEASURE percentile(double q) const {
+			OPCOUNT_MEASURE rank = (OPCOUNT_MEASURE)ceil(q * total);
+			OPCOUNT_MEASURE seen = 0;
+			for (size_t i = 0; i < buckets.size(); ++i) {
+				seen += buckets[i];
+				if (seen >= rank && seen > 0) {
+					return std::min(bucketTop(i), largest);
+				}
+			}
+			return largest;
+		}
+
+	private:
+		static const int SUB_BUCKET_BITS = 5;
+
+		static size_t bucketOf(OPCOUNT_MEASURE value) {
+			int shift = -SUB_BUCKET_BITS;
+			if (value < (2ULL << SUB_BUCKET_BITS)) {
+				return (size_t)value;
+			}
+			for (OPCOUNT_MEASURE rest = value; rest > 1; rest >>= 1) {
+				shift++;
+			}
+			return ((size_t)(shift + 1) << SUB_BUCKET_BITS) + (size_t)(value >> shift) - ((size_t)1 << SUB_BUCKET_BITS);
+		}
+
+		static OPCOUNT_MEASURE bucketTop(size_t index) {
+			if (index < ((size_t)2 << SUB_BUCKET_BITS)) {
+				return (OPCOUNT_MEASURE)index;
+			}
+			int shift = (int)(index >> SUB_BUCKET_BITS) - 1;
+			OPCOUNT_MEASURE top = (index & ((1 << SUB_BUCKET_BITS) - 1)) + (1 << SUB_BUCKET_BITS);
+			return ((top + 1) << shift) - 1;
+		}
+	};
+
+	/**
+	* histogram of operation name at the specified size, for the calling thread
+	* the report shows it as the series "<name> p50", "<name> p90", "<name> p99",
+	* "<name> p99.9" and "<name> max", grouped in "<name> percentiles"
+	* the reference is valid until the next report
+	*/
+	Histogram& histogram(const char* name, SIZE_MEASURE size) {
+		return localShard().histograms[TimerKey(name, size)];
+	}
+
+private:
+	typedef std::map<SIZE_MEASURE, double> OpcountSequence; // doubles, so averages and medians keep their fractions
+	typedef std::map<std::string, OpcountSequence> OpcountMap;
+
+	typedef std::map<std::string, std::vector<std::string> > GroupMap;
+
+	struct RegisteredOperation {
+		std::string name;
+		int bucketWidth;
+	};
+
+	struct FlatSeries {
+		int bucketWidth;
+		std::vector<OPCOUNT_MEASURE> values;
+		std::vector<unsigned char> touched;
+	};
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct TimeSample {
+		double nanoseconds;
+		double cycles;
+	};
+
+	struct TimerStart {
+		Clock::time_point time;
+		unsigned long long cycles;
+	};
+
+	struct TraceEvent {
+		std::string name;
+		int thread;
+		double start;
+		double duration;
+	};
+
+	typedef std::pair<std::string, SIZE_MEASURE> TimerKey;
+	typedef std::map<SIZE_MEASURE, std::vector<TimeSample> > TimeSequence;
+	typedef std::map<std::string, TimeSequence> TimeMap;
+
+	enum HardwareEvent {
+		HW_CYCLES = 0, HW_INSTRUCTIONS = 1, HW_L1D_MISSES = 2,
+		HW_LLC_MISSES = 3, HW_DTLB_MISSES = 4, HW_BRANCH_MISSES = 5, HW_EVENT_COUNT = 6
+	};
+
+	/**
+	* the hardware events of one timed run of a BenchmarkRunner
+	*/
+	struct HwSample {
+		double value[HW_EVENT_COUNT];
+		bool present[HW_EVENT_COUNT];
+	};
+
+	struct HwReading {
+		unsigned long long value[HW_EVENT_COUNT];
+		unsigned long long enabled[HW_EVENT_COUNT];
+		unsigned long long running[HW_EVENT_COUNT];
+	};
+
+	enum TimeStatistic { TIME_MIN = 0, TIME_MEDIAN = 1, TIME_MEAN = 2, TIME_P95 = 3, TIME_CYCLES = 4, TIME_STAT_COUNT = 5 };
+
+	/**
+	* everything a thread records, aligned to a cache line so that shards of
+	* different threads never share one; only the owner thread touches its
+	* shard until the shards are merged
+	*/
+	struct alignas(64) CounterShard {
+		unsigned long long owner; // ThreadToken of the thread, 0 once it has ended
+		int thread;
+		OpcountMap opcountMap;
+		TimeMap timeMap;
+		std::map<TimerKey, TimerStart> runningTimers;
+		std::vector<FlatSeries> flatSeries;
+		bool hwOpened;
+		int hwEventFd[HW_EVENT_COUNT];
+		std::map<TimerKey, HwReading> runningHwCounters;
+		std::map<TimerKey, AllocationStats> runningAllocations;
+		std::vector<TraceEvent> openTraces;
+		std::vector<TraceEvent> traceEvents;
+		std::map<TimerKey, Histogram> histograms;
+	};
+
+public:
+	class OperationCounter {
+		OpcountSequence::iterator ptrInMap;
+		Profiler& profiler;
+		friend class Profiler;
+		OperationCounter(Profiler& prof, const char* name, SIZE_MEASURE size) : profiler(prof) {
+			profiler.opcountMap[name][size]; // force creation
+			ptrInMap = profiler.opcountMap[name].find(size);
+		}
+	public:
+		void count(OPCOUNT_MEASURE increment = 1) { ptrInMap->second += increment; }
+		OPCOUNT_MEASURE get() const { return (OPCOUNT_MEASURE)ptrInMap->second; }
+	};
+
+	/**
+	* the returned counter writes straight into the merged data,
+	* so it should only be used by one thread at a time
+	*/
+	OperationCounter createOperation(const char* name, SIZE_MEASURE size) {
+		mergeShards();
+		return OperationCounter(*this, name, size);
+	}
+
+	class ScopedTimer {
+		Profiler& profiler;
+		std::string name;
+		SIZE_MEASURE size;
+	public:
+		ScopedTimer(Profiler& prof, const char* name, SIZE_MEASURE size) : profiler(prof), name(name), size(size) {
+			profiler.startTimer(name, size);
+		}
+		~ScopedTimer() { profiler.stopTimer(name.c_str(), size); }
+	};
+
+	class ScopedHardwareCounters {
+		Profiler& profiler;
+		std::string name;
+		SIZE_MEASURE size;
+	public:
+		ScopedHardwareCounters(Profiler& prof, const char* name, SIZE_MEASURE size) : profiler(prof), name(name), size(size) {
+			profiler.startHardwareCounters(name, size);
+		}
+		~ScopedHardwareCounters() { profiler.stopHardwareCounters(name.c_str(), size); }
+	};
+
+	class ScopedAllocations {
+		Profiler& profiler;
+		std::string name;
+		SIZE_MEASURE size;
+	public:
+		ScopedAllocations(Profiler& prof, const char* name, SIZE_MEASURE size) : profiler(prof), name(name), size(size) {
+			profiler.startAllocations(name, size);
+		}
+		~ScopedAllocations() { profiler.stopAllocations(name.c_str(), size); }
+	};
+
+	class ScopedTrace {
+		Profiler& profiler;
+	public:
+		ScopedTrace(Profiler& prof, const char* name) : profiler(prof) {
+			profiler.beginTrace(name);
+		}
+		~ScopedTrace() { profiler.endTrace(); }
+	};
+
+	/**
+	* repeats the measurement of one size until the results are stable:
+	*	for (BenchmarkRunner run(profiler, size); run.next(); ) {
+	*		...build the input and run the counted kernel...
+	*		run.record(QS_AVG, QS_OP);
+	*		run.time(QS_AVG, [&]() { quickSort<NullPolicy>(...); });
+	*	}
+	* the first runs only warm up, then the runs go on until the 95% confidence
+	* interval of every series is within targetError of its mean (at most maxRuns);
+	* the samples outside the Tukey fences are dropped and each series is reported
+	* as its median, "<name> min" and "<name> p95" (fractions are kept, so record
+	* may be given averages); timed series also get the usual mean and cycles,
+	* and their hardware counters are averaged over the runs that were kept
+	*/
+	class BenchmarkRunner {
+		Profiler& profiler;
+		SIZE_MEASURE size;
+		int warmup, minRuns, maxRuns, run;
+		double targetError;
+		bool finished;
+		std::map<std::string, std::vector<double> > counts;
+		std::map<std::string, std::vector<TimeSample> > times;
+		std::map<std::string, std::vector<HwSample> > hardware;
+		std::map<std::string, std::vector<Histogram> > histograms;
+	public:
+		BenchmarkRunner(Profiler& prof, SIZE_MEASURE size, int warmup = 1, int minRuns = 5, int maxRuns = 30, double targetError = 0.02)
+			: profiler(prof), size(size), warmup(warmup), minRuns(minRuns), maxRuns(maxRuns), run(-1), targetError(targetError), finished(false) {
+		}
+
+		~BenchmarkRunner() {
+			finish();
+		}
+
+		/**
+		* starts the next run, returns false (and reports) once the series are stable
+		*/
+		bool next() {
+			if (finished) {
+				return false;
+			}
+			++run;
+			if (run < warmup + minRuns || (run < warmup + maxRuns && !stable())) {
+				return true;
+			}
+			finish();
+			return false;
+		}
+
+		/**
+		* the value of a series in this run, ignored while warming up
+		*/
+		void record(const char* name, double value) {
+			if (run >= warmup) {
+				counts[name].push_back(value);
+			}
+		}
+
+		/**
+		* the histogram of a series in this run, ignored while warming up; it is
+		* merged into profiler.histogram(name, size) only if the run is kept
+		*/
+		void record(const char* name, const Histogram& histogram) {
+			if (run >= warmup) {
+				std::vector<Histogram>& runs = histograms[name];
+				runs.resize(run - warmup + 1);
+				runs[run - warmup].merge(histogram);
+			}
+		}
+
+		/**
+		* runs and times the given function as one sample of series name
+		*/
+		template <typename Function>
+		void time(const char* name, Function function) {
+			if (run < warmup) {
+				function();
+				return;
+			}
+			TimeSample sample;
+			HwSample events;
+			double before[HW_EVENT_COUNT];
+			hardwareTotals(name, before);
+			profiler.startHardwareCounters(name, size);
+			unsigned long long startCycles = readCycles();
+			Clock::time_point start = Clock::now();
+			function();
+			Clock::time_point stop = Clock::now();
+			sample.cycles = (double)(readCycles() - startCycles);
+			profiler.stopHardwareCounters(name, size);
+			sample.nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+			takeHardwareSample(name, before, events);
+			times[name].push_back(sample);
+			hardware[name].push_back(events);
+		}
+
+	private:
+		/**
+		* the hardware counters of one timed run, held back until finish knows
+		* whether the run is an outlier
+		*/
+		void hardwareTotals(const char* name, double* totals) {
+			CounterShard& shard = profiler.localShard();
+			for (int event = 0; event < HW_EVENT_COUNT; ++event) {
+				OpcountMap::const_iterator series = shard.opcountMap.find(name + std::string(hwEventSuffix(event)));
+				OpcountSequence::const_iterator point;
+				totals[event] = 0;
+				if (series != shard.opcountMap.end() && (point = series->second.find(size)) != series->second.end()) {
+					totals[event] = point->second;
+				}
+			}
+		}
+
+		void takeHardwareSample(const char* name, const double* before, HwSample& events) {
+			CounterShard& shard = profiler.localShard();
+			for (int event = 0; event < HW_EVENT_COUNT; ++event) {
+				OpcountMap::iterator series = shard.opcountMap.find(name + std::string(hwEventSuffix(event)));
+				events.present[event] = series != shard.opcountMap.end() && series->second.find(size) != series->second.end();
+				events.value[event] = 0;
+				if (events.present[event]) {
+					events.value[event] = series->second[size] - before[event];
+					series->second[size] = before[event];
+				}
+			}
+		}
+
+		bool stable() const {
+			std::map<std::string, std::vector<double> >::const_iterator cit;
+			std::map<std::string, std::vector<TimeSample> >::const_iterator tit;
+			for (cit = counts.begin(); cit != counts.end(); ++cit) {
+				if (!stable(cit->second)) {
+					return false;
+				}
+			}
+			for (tit = times.begin(); tit != times.end(); ++tit) {
+				if (!stable(nanoseconds(tit->second))) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		bool stable(const std::vector<double>& samples) const {
+			std::vector<double> values = withoutOutliers(samples);
+			double mean = 0, variance = 0;
+			size_t i;
+			if (values.size() < 2) {
+				return false;
+			}
+			for (i = 0; i < values.size(); ++i) {
+				mean += values[i];
+			}
+			mean /= values.size();
+			for (i = 0; i < values.size(); ++i) {
+				variance += (values[i] - mean) * (values[i] - mean);
+			}
+			variance /= values.size() - 1;
+			return 1.96 * sqrt(variance / values.size()) <= targetError * fabs(mean);
+		}
+
+		/**
+		* the runs none of whose values is an outlier of its series, the i-th
+		* value of a series belongs to the i-th counted run
+		*/
+		std::vector<bool> keptRunMask(size_t runs) const {
+			std::map<std::string, std::vector<double> >::const_iterator cit;
+			std::map<std::string, std::vector<TimeSample> >::const_iterator tit;
+			std::vector<bool> kept(runs, true);
+			for (cit = counts.begin(); cit != counts.end(); ++cit) {
+				markOutliers(cit->second, kept);
+			}
+			for (tit = times.begin(); tit != times.end(); ++tit) {
+				markOutliers(nanoseconds(tit->second), kept);
+			}
+			return kept;
+		}
+
+		static void markOutliers(const std::vector<double>& samples, std::vector<bool>& kept) {
+			std::vector<double> values = withoutOutliers(samples);
+			for (size_t i = 0; i < samples.size() && i < kept.size(); ++i) {
+				if (values.empty() || samples[i] < values.front() || samples[i] > values.back()) {
+					kept[i] = false;
+				}
+			}
+		}
+
+		static std::vector<double> nanoseconds(const std::vector<TimeSample>& samples) {
+			std::vector<double> values(samples.size());
+			for (size_t i = 0; i < samples.size(); ++i) {
+				values[i] = samples[i].nanoseconds;
+			}
+			return values;
+		}
+
+		void finish() {
+			std::map<std::string, std::vector<double> >::const_iterator cit;
+			std::map<std::string, std::vector<TimeSample> >::const_iterator tit;
+			if (finished) {
+				return;
+			}
+			finished = true;
+			CounterShard& shard = profiler.localShard();
+			for (cit = counts.begin(); cit != counts.end(); ++cit) {
+				std::vector<double> values = withoutOutliers(cit->second);
+				if (values.empty()) {
+					continue;
+				}
+				shard.opcountMap[cit->first][size] += quantile(values, 0.5);
+				shard.opcountMap[cit->first + " min"][size] += values.front();
+				shard.opcountMap[cit->first + " p95"][size] += quantile(values, 0.95);
+			}
+			for (tit = times.begin(); tit != times.end(); ++tit) {
+				std::vector<double> values = withoutOutliers(nanoseconds(tit->second));
+				std::vector<TimeSample>& kept = shard.timeMap[tit->first][size];
+				const std::vector<HwSample>& events = hardware[tit->first];
+				double eventSum[HW_EVENT_COUNT] = { 0 };
+				bool eventPresent[HW_EVENT_COUNT] = { false };
+				size_t keptRuns = 0;
+				for (size_t i = 0; i < tit->second.size(); ++i) {
+					if (!values.empty() && tit->second[i].nanoseconds >= values.front() && tit->second[i].nanoseconds <= values.back()) {
+						kept.push_back(tit->second[i]);
+						keptRuns++;
+						for (int event = 0; event < HW_EVENT_COUNT; ++event) {
+							eventSum[event] += events[i].value[event];
+							eventPresent[event] = eventPresent[event] || events[i].present[event];
+						}
+					}
+				}
+				for (int event = 0; event < HW_EVENT_COUNT; ++event) {
+					if (eventPresent[event]) {
+						shard.opcountMap[tit->first + hwEventSuffix(event)][size] += eventSum[event] / keptRuns;
+					}
+				}
+			}
+			for (std::map<std::string, std::vector<Histogram> >::const_iterator hit = histograms.begin(); hit != histograms.end(); ++hit) {
+				std::vector<bool> kept = keptRunMask(hit->second.size());
+				for (size_t i = 0; i < hit->second.size(); ++i) {
+					if (kept[i]) {
+						shard.histograms[TimerKey(hit->first, size)].merge(hit->second[i]);
+					}
+				}
+			}
+		}
+	};
+
+private:
+	/**
+	* collects the report in a large buffer and hands it to the file in
+	* blocks, so that big reports do not cost one stdio call per value
+	*/
+	class ReportWriter;
+
+	typedef std::map<std::string, std::map<SIZE_MEASURE, double> > BaselineMap;
+
+	/**
+	* reads back the opcount and times sections of a JSON report,
+	* every other member is skipped
+	*/
+	class BaselineParser;
+
+	std::string title;
+	OpcountMap opcountMap;
+	GroupMap groups;
+	TimeMap timeMap;
+	std::map<std::string, std::pair<char, SIZE_MEASURE> > fixedSizes;
+	unsigned long long id;
+	bool hwEnabled;
+	int reportFormats;
+	std::string reportFileName;
+	bool baselineLoaded;
+	bool regressionFound;
+	double regressionThreshold[2];
+	BaselineMap baselineOpcount;
+	BaselineMap baselineTimes;
+	Clock::time_point traceOrigin;
+	unsigned long long mainThread;
+	std::vector<TraceEvent> traceEvents;
+	std::map<TimerKey, Histogram> histograms;
+	std::mutex shardLock;
+	std::vector<CounterShard*> shards;
+	std::vector<RegisteredOperation> registered;
+
+	Profiler(const Profiler&);
+	Profiler& operator=(const Profiler&);
+
+	static unsigned long long nextProfilerId() {
+		static std::atomic<unsigned long long> lastId(0);
+		return ++lastId;
+	}
+
+	/**
+	* returns the shard of the calling thread, creating it on first use (or
+	* taking over the shard of a thread that has ended, its counters are merged
+	* all the same and its hardware counters were closed)
+	* the last shard used is cached per thread, so the lock is only taken
+	* when a thread switches between profilers
+	*/
+	CounterShard& localShard() {
+		static thread_local unsigned long long cachedId = 0;
+		static thread_local CounterShard* cachedShard = NULL;
+		if (cachedId != id) {
+			std::lock_guard<std::mutex> lock(shardLock);
+			unsigned long long self = ThreadToken();
+			cachedShard = NULL;
+			for (size_t i = 0; i < shards.size() && cachedShard == NULL; ++i) {
+				if (shards[i]->owner == self) {
+					cachedShard = shards[i];
+				}
+			}
+			for (size_t i = 0; i < shards.size() && cachedShard == NULL; ++i) {
+				if (shards[i]->owner == 0) {
+					cachedShard = shards[i];
+					cachedShard->owner = self;
+				}
+			}
+			if (cachedShard == NULL) {
+				cachedShard = new CounterShard();
+				cachedShard->owner = self;
+				cachedShard->thread = (int)shards.size() + 1;
+				cachedShard->hwOpened = false;
+				for (int i = 0; i < HW_EVENT_COUNT; ++i) {
+					cachedShard->hwEventFd[i] = -1;
+				}
+				shards.push_back(cachedShard);
+			}
+			cachedId = id;
+		}
+		return *cachedShard;
+	}
+
+	/**
+	* moves the counters and the finished runs of every thread into the
+	* merged data; threads should not be counting while this happens
+	*/
+	void mergeShards();
+
+	/**
+	* slow path of countOperation(OperationId, ...): makes room in the
+	* calling thread's shard for the operation and the size
+	*/
+	void growFlatSeries(CounterShard& shard, OperationId op, SIZE_MEASURE size);
+
+	bool openHardwareCounters(CounterShard& shard);
+
+	friend void ReleaseThreadCounters();
+
+	/**
+	* the profilers alive, so that an ending thread can find its shards
+	*/
+	static void addLiveProfiler(Profiler* profiler);
+
+	static void removeLiveProfiler(Profiler* profiler);
+
+	/**
+	* closes the hardware counters of the calling thread's shard and marks it as free
+	*/
+	void releaseLocalShard();
+
+	void closeHardwareCounters(CounterShard& shard);
+
+	void readHardwareCounters(const CounterShard& shard, HwReading& reading);
+
+	static const char* hwEventSuffix(int event);
+
+	static unsigned long long readCycles() {
+#ifdef PROFILER_HAS_TSC
+		return __rdtsc();
+#else
+		return 0;
+#endif
+	}
+
+	static const char* timeStatSuffix(int stat);
+
+	/**
+	* reduces the runs recorded for one point to the requested statistic
+	* TIME_CYCLES is the median of the cycle counts
+	*/
+	static double timeStatistic(const std::vector<TimeSample>& runs, int stat);
+
+	/**
+	* the q-quantile of sorted values, interpolating between neighbours
+	*/
+	static double quantile(const std::vector<double>& sorted, double q);
+
+	/**
+	* sorts the values and drops the ones outside the Tukey fences
+	* (more than 1.5 interquartile ranges away from the quartiles)
+	*/
+	static std::vector<double> withoutOutliers(std::vector<double> values);
+
+	/**
+	* compares the current data with the baseline: the operation counts of every
+	* series and the median of every timed series, at every size present in both
+	* returns 1 if a point grew beyond its threshold, 0 otherwise (-1 on I/O errors)
+	*/
+	int writeDiff(const std::string& reportName);
+
+	bool writeDiffPoint(ReportWriter& out, int section, const std::string& name, SIZE_MEASURE size, double current);
+
+	/**
+	* turns every histogram into its percentile series and their group
+	*/
+	void addHistogramSeries();
+
+	/**
+	* writes one format of the report to <name>.<extension>, or to stdout
+	*/
+	int writeReport(const std::string& name, int format);
+
+	/**
+	* writes the trace regions in the Chrome trace event format: one complete
+	* ("X") event per region, in microseconds since the profiler was created,
+	* and a name for the process and for every thread that recorded a region
+	*/
+	void writeTrace(ReportWriter& out);
+
+	/**
+	* writes the data as a JSON object with the opcount, times and groups
+	* sections; the html page needs the names reduced to identifiers,
+	* the plain JSON report keeps them as they were given
+	*/
+	void writeJson(ReportWriter& out, bool identifiers);
+
+	/**
+	* writes the data as CSV, one row per point: section,series,size,value
+	*/
+	void writeCsv(ReportWriter& out);
+
+	void writeJsonFit(ReportWriter& out, const std::string& name, const ComplexityFit& fit, bool identifiers);
+
+	static void writeCsvFit(ReportWriter& out, const char* section, const std::string& name, const ComplexityFit& fit);
+
+	/**
+	* the fit of the median run of a timed series
+	*/
+	ComplexityFit fitTimes(const std::string& name, const TimeSequence& sequence);
+
+	enum ComplexityModel {
+		MODEL_CONSTANT = 0, MODEL_LOG = 1, MODEL_LINEAR = 2, MODEL_N_LOG_N = 3,
+		MODEL_QUADRATIC = 4, MODEL_N_LOG_K = 5, MODEL_COUNT = 6
+	};
+
+	/**
+	* least squares fit of y = constant * model(x) for every model, keeping the
+	* one with the highest R^2 (the constant model is only kept for flat series)
+	*/
+	ComplexityFit fitPoints(const std::string& name, const std::vector<std::pair<double, double> >& points);
+
+	static double complexityModel(int model, double x, const std::pair<char, SIZE_MEASURE>* fixed);
+
+	static void writeJsonName(ReportWriter& out, const std::string& name, bool identifier);
+
+	static void writeCsvName(ReportWriter& out, const std::string& name);
+
+	static void print_modified(ReportWriter& out, const char* str);
+};
+
+typedef Profiler::OperationCounter Operation;
+typedef Profiler::ScopedTimer Timer;
+typedef Profiler::ScopedHardwareCounters HardwareCounters;
+typedef Profiler::OperationId OperationId;
+typedef Profiler::BenchmarkRunner BenchmarkRunner;
+
+/**
+* instrumentation policies for the algorithms
+* an algorithm written as template <typename Count> bumps its counters through
+* Count::add(counter, increment): instantiated with CountingPolicy it is the
+* counted benchmark kernel, with NullPolicy the calls compile to nothing and
+* it is the uninstrumented production kernel
+*/
+struct CountingPolicy {
+	static const bool enabled = true;
+
+	template <typename T>
+	static inline void add(T& counter, Profiler::OPCOUNT_MEASURE increment = 1) {
+		counter += increment;
+	}
+};
+
+struct NullPolicy {
+	static const bool enabled = false;
+
+	template <typename T>
+	static inline void add(T&, Profiler::OPCOUNT_MEASURE = 1) {
+	}
+};
+
+enum SortMethod {
+	UNSORTED = 0, ASCENDING = 1, DESCENDING = 2, NEARLY_SORTED = 3, FEW_UNIQUE = 4,
+	ORGAN_PIPE = 5, SAWTOOTH = 6, ZIPF = 7, MEDIAN_OF_3_KILLER = 8, SORT_METHOD_COUNT = 9
+};
+
+/**
+* name of a SortMethod, to build the series names of a sweep over the distributions
+*/
+inline const char* SortMethodName(int method) {
+	switch (method) {
+	case UNSORTED: return "random";
+	case ASCENDING: return "ascending";
+	case DESCENDING: return "descending";
+	case NEARLY_SORTED: return "nearly sorted";
+	case FEW_UNIQUE: return "few unique";
+	case ORGAN_PIPE: return "organ pipe";
+	case SAWTOOTH: return "sawtooth";
+	case ZIPF: return "zipf";
+	default: return "median of 3 killer";
+	}
+}
+
+/**
+* puts the elements of the given array in a uniformly random order (Fisher-Yates)
+*/
+template <typename T>
+void ShuffleArray(T* arr, int size) {
+	RandomGenerator& generator = RandomEngine();
+	for (int i = size - 1; i > 0; --i) {
+		std::swap(arr[i], arr[generator.nextBelow(i + 1)]);
+	}
+}
+
+/**
+* fills the array with values drawn from only FEW_UNIQUE_KEYS random keys
+*/
+static const int FEW_UNIQUE_KEYS = 16;
+
+template <typename T>
+void FillFewUniqueArray(T* arr, int size, T range_min, T range_max, bool discreteType) {
+	T keys[FEW_UNIQUE_KEYS];
+	RandomGenerator& generator = RandomEngine();
+	unsigned long long discrete_len = (unsigned long long)((long long)range_max - (long long)range_min) + 1;
+	for (int i = 0; i < FEW_UNIQUE_KEYS; ++i) {
+		if (discreteType) {
+			keys[i] = (T)((long long)range_min + (long long)generator.nextBelow(discrete_len));
+		}
+		else {
+			keys[i] = range_min + (T)generator.nextDouble() * (range_max - range_min);
+		}
+	}
+	unsigned long long streams = generator.next();
+	ParallelBlocks(size, RANDOM_BLOCK_SIZE, [&](long long block, long long begin, long long end) {
+		RandomGenerator stream(streams, (unsigned long long)block);
+		for (long long k = begin; k < end; ++k) {
+			arr[k] = keys[stream.nextBelow(FEW_UNIQUE_KEYS)];
+		}
+	});
+}
+
+/**
+* fills the array with Zipf distributed keys (exponent 1): the value range_min
+* is the most frequent, the k-th value of the range is k times less frequent;
+* wide ranges are cut to 2^20 ranks spread evenly over the range
+*/
+template <typename T>
+void FillZipfArray(T* arr, int size, T range_min, T range_max, bool discreteType) {
+	unsigned long long discrete_len = (unsigned long long)((long long)range_max - (long long)range_min) + 1;
+	size_t ranks = 1 << 20;
+	if (discreteType && discrete_len < ranks) {
+		ranks = (size_t)discrete_len;
+	}
+	std::vector<double> cumulated(ranks);
+	double total = 0;
+	for (size_t i = 0; i < ranks; ++i) {
+		total += 1.0 / (i + 1);
+		cumulated[i] = total;
+	}
+	unsigned long long streams = RandomEngine().next();
+	ParallelBlocks(size, RANDOM_BLOCK_SIZE, [&](long long block, long long begin, long long end) {
+		RandomGenerator stream(streams, (unsigned long long)block);
+		for (long long k = begin; k < end; ++k) {
+			size_t rank = std::lower_bound(cumulated.begin(), cumulated.end(), stream.nextDouble() * total) - cumulated.begin();
+			if (rank >= ranks) {
+				rank = ranks - 1;
+			}
+			if (discreteType) {
+				arr[k] = (T)((long long)range_min + (long long)(rank * (discrete_len / ranks)));
+			}
+			else {
+				arr[k] = range_min + (T)((double)rank / ranks) * (range_max - range_min);
+			}
+		}
+	});
+}
+
+/**
+* rearranges an array sorted in ascending order into the shape of the given
+* SortMethod (NEARLY_SORTED, ORGAN_PIPE, SAWTOOTH or MEDIAN_OF_3_KILLER)
+*/
+static const int SAWTOOTH_TEETH = 8;
+
+template <typename T>
+void ArrangeSortedArray(T* arr, int size, int method) {
+	RandomGenerator& generator = RandomEngine();
+	std::vector<T> sorted(arr, arr + size);
+	int i, half;
+
+	if (method == NEARLY_SORTED) {
+		//1% of the elements swapped with a random partner
+		for (i = 0; i < std::max(1, size / 100) && size > 1; ++i) {
+			std::swap(arr[generator.nextBelow(size)], arr[generator.nextBelow(size)]);
+		}
+	}
+	else if (method == ORGAN_PIPE) {
+		//up with every other value, down with the ones left
+		for (i = 0; i < size; ++i) {
+			if (i % 2 == 0) {
+				arr[i / 2] = sorted[i];
+			}
+			else {
+				arr[size - 1 - i / 2] = sorted[i];
+			}
+		}
+	}
+	else if (method == SAWTOOTH) {
+		//value i goes to tooth i % SAWTOOTH_TEETH, so every tooth spans the whole range
+		std::vector<int> start(SAWTOOTH_TEETH + 1, 0);
+		for (i = 0; i < SAWTOOTH_TEETH; ++i) {
+			start[i + 1] = start[i] + (size - i + SAWTOOTH_TEETH - 1) / SAWTOOTH_TEETH;
+		}
+		for (i = 0; i < size; ++i) {
+			arr[start[i % SAWTOOTH_TEETH] + i / SAWTOOTH_TEETH] = sorted[i];
+		}
+	}
+	else if (method == MEDIAN_OF_3_KILLER) {
+		//Musser's sequence: a quicksort taking the median of the first, middle and
+		//last elements as pivot only splits off two elements per partition
+		//the construction needs an even half, so it is built on the largest multiple
+		//of 4 and the (at most 3) largest values are left in order at the end
+		half = (size - size % 4) / 2;
+		for (i = 1; i <= half; ++i) {
+			if (i % 2 == 1) {
+				arr[i - 1] = sorted[i - 1];
+				arr[i] = sorted[half + i - 1];
+			}
+			arr[half + i - 1] = sorted[2 * i - 1];
+		}
+		for (i = 2 * half; i < size; ++i) {
+			arr[i] = sorted[i];
+		}
+	}
+}
+
+/**
+* fills the given array with random elements in the given range.
+* optionally, the array can be unique or sorted in ascending (1) or descending (2) order,
+* or follow one of the other SortMethod distributions (FEW_UNIQUE and ZIPF cannot be unique)
+* the unique values cost O(size), whatever the width of the range; the other
+* ones are generated on all the input threads, with the same result for any count
+*/
+template <typename T>
+void FillRandomArray(T* arr, int size, T range_min = 10, T range_max = 50000, bool unique = false, int sorted = UNSORTED) {
+	int pos, shape;
+	long long j, extendedSize;
+	bool discreteType = true;
+	T interval_len = range_max - range_min + 1;
+	unsigned long long discrete_len = (unsigned long long)((long long)range_max - (long long)range_min) + 1;
+	RandomGenerator& generator = RandomEngine();
+
+	if (range_min >= range_max) {
+		throw "empty range";
+	}
+
+	if (typeid(T) == typeid(double) || typeid(T) == typeid(float)) {
+		discreteType = false;
+	}
+	if (sorted == FEW_UNIQUE || sorted == ZIPF) {
+		if (unique) {
+			throw "distribution with repeated values";
+		}
+		if (sorted == FEW_UNIQUE) {
+			FillFewUniqueArray(arr, size, range_min, range_max, discreteType);
+		}
+		else {
+			FillZipfArray(arr, size, range_min, range_max, discreteType);
+		}
+		return;
+	}
+	//the other shapes are built from the values sorted in ascending order
+	shape = sorted;
+	if (shape > DESCENDING) {
+		sorted = ASCENDING;
+	}
+	if (!unique) {
+		//no worries, every block comes from its own stream and can be filled in parallel
+		unsigned long long streams = generator.next();
+		ParallelBlocks(size, RANDOM_BLOCK_SIZE, [&](long long block, long long begin, long long end) {
+			RandomGenerator stream(streams, (unsigned long long)block);
+			for (long long k = begin; k < end; ++k) {
+				if (discreteType) {
+					arr[k] = (T)((long long)range_min + (long long)stream.nextBelow(discrete_len));
+				}
+				else {
+					arr[k] = range_min + (T)stream.nextDouble() * (interval_len - 1);
+				}
+			}
+		});
+		if (sorted == ASCENDING) {
+			std::sort(arr, arr + size);
+		}
+		else if (sorted == DESCENDING) {
+			std::sort(arr, arr + size, std::greater<T>());
+		}
+	}
+	else if (discreteType && discrete_len > 2 * (unsigned long long)size) {
+		//the range is much wider than the array, use Floyd's sampling:
+		//every step adds exactly one new value, so only size values are drawn
+		//the picks are kept in an open addressing table, a value v is stored as v + 1
+		size_t mask = 1;
+		while (mask < 2 * (size_t)size) {
+			mask <<= 1;
+		}
+		std::vector<unsigned long long> picked(mask, 0);
+		mask -= 1;
+		pos = 0;
+		for (j = (long long)(discrete_len - size); j < (long long)discrete_len; ++j) {
+			unsigned long long value = generator.nextBelow((unsigned long long)j + 1);
+			size_t slot = (size_t)((value * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+			while (picked[slot] != 0 && picked[slot] != value + 1) {
+				slot = (slot + 1) & mask;
+			}
+			if (picked[slot] != 0) {
+				//already taken, j itself cannot have been picked before
+				value = (unsigned long long)j;
+				slot = (size_t)((value * 0x9E3779B97F4A7C15ULL) >> 20) & mask;
+				while (picked[slot] != 0) {
+					slot = (slot + 1) & mask;
+				}
+			}
+			picked[slot] = value + 1;
+			arr[pos++] = (T)((long long)range_min + (long long)value);
+		}
+		//the order of the picks is not uniform, so sort or shuffle it
+		if (sorted == ASCENDING) {
+			std::sort(arr, arr + size);
+		}
+		else if (sorted == DESCENDING) {
+			std::sort(arr, arr + size, std::greater<T>());
+		}
+		else {
+			ShuffleArray(arr, size);
+		}
+	}
+	else {
+		//use Knuth approach, the range is at most twice the size
+		if (discreteType) {
+			if (discrete_len < (unsigned long long)size) {
+				throw "range too small";
+			}
+			pos = 0;
+			for (j = 0; (unsigned long long)j < discrete_len && pos < size; ++j) {
+				if (generator.nextBelow(discrete_len - j) < (unsigned long long)(size - pos)) {
+					arr[pos++] = (T)((long long)range_min + j);
+				}
+			}
+		}
+		else {
+			//use the same approach as above, pick integers from 0 to 17*size
+			extendedSize = 17 * (long long)size;
+			pos = 0;
+			for (j = 0; j < extendedSize && pos < size; ++j) {
+				if (generator.nextBelow(extendedSize - j) < (unsigned long long)(size - pos)) {
+					arr[pos++] = range_min + ((T)j / extendedSize) * (interval_len - 1);
+				}
+			}
+		}
+		//we got a sorted array in ascending order
+		if (sorted == DESCENDING) {
+			std::reverse(arr, arr + size);
+		}
+		else if (sorted == UNSORTED) {
+			ShuffleArray(arr, size);
+		}
+	}
+	if (shape > DESCENDING) {
+		ArrangeSortedArray(arr, size, shape);
+	}
+}
+
+template <typename T>
+void CopyArray(T* dst, T* src, int size) {
+	memcpy(dst, src, size * sizeof(T));
+}
+
+/**
+* Checks if the given array is sorted or not.
+*/
+template <typename T>
+bool IsSorted(T* arr, int size) {
+	int i;
+	for (i = 1; i < size; ++i) {
+		if (arr[i] < arr[i - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#endif
+
+/**
+* defined before including this file, the malloc family of the including file
+* goes through the allocation counters read by Profiler::startAllocations;
+* this file has to be the last one included
+*/
+#ifdef PROFILER_TRACK_ALLOCATIONS
+#   define malloc(size) TrackedMalloc(size)
+#   define calloc(count, size) TrackedCalloc(count, size)
+#   define realloc(block, size) TrackedRealloc(block, size)
+#   define free(block) TrackedFree(block)
+#endif
+
+
@@ -1,15 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 #define HS_AVG "HeapSort Average"
 #define QS_AVG "QuickSort Average"
+#define BQS_AVG "Block QuickSort Average"
 
 #define QS_WORST_ASC "QuickSort Worst Ascending"
 #define QS_WORST_DESC "QuickSort Worst Descending"
 #define QS_BEST "QuickSort Best"
 
+#define IS_AVG "IntroSort Average"
+#define IS_WORST_ASC "IntroSort Worst Ascending"
+#define IS_WORST_DESC "IntroSort Worst Descending"
+
+#define DUPLICATES_MIN 10
+#define DUPLICATES_MAX 20
+
 /*
 	QuickSort
 	----------
@@ -59,10 +67,49 @@
 	          the way up to O(n^2). If the array is sorted ascending is does even much more operations than when it's descending. This
 			  being the worst puts quicksort in very bad position compared to its competitors because in many cases sorting is done on 
 			  almost-sorted arrays and O(n^2) is no near O(n*log n) offered by heapsort or mergesort.
+----------------------------------------------------------------------------------------------------------------------------------------
+
+	IntroSort
+	----------
+		It is quicksort which keeps an eye on its own recursion depth. As long as the partitions are balanced it does exactly what
+	  quicksort does, including the insertion sort of the small ranges. Once the depth goes past 2*log2(n) the pivots were clearly bad
+	  and the range left is sorted with heapsort instead.
+
+		Running time
+			At most 2*log2(n) levels of partitioning, O(n) each, and heapsort on what is left, so O(n*log n) in every case. The
+		  ascending and descending arrays which are the worst case of quicksort hit the depth limit and end up in heapsort.
+
+		Stack
+			Only the smaller side of a partition is sorted recursively, the larger one is sorted by the same call, thus the
+		  recursion depth is at most log2(n) whatever the pivots are.
+----------------------------------------------------------------------------------------------------------------------------------------
+
+	3-way and Dual-Pivot QuickSort
+	-------------------------------
+		Both split the range in three instead of two. The 3-way partition (Dutch national flag) groups the elements less than,
+	  equal to and greater than the pivot, the equal ones are in their final place and are never touched again. The dual pivot
+	  one (Yaroslavskiy) takes two pivots p <= q and splits around both, the middle part being the elements between them.
+
+		Running time
+			With only k distinct keys the 3-way version does at most k levels of partitioning, so O(n*k) and near linear for keys
+		  like status codes or bucket ids, where the classic partition puts all the copies of the pivot on one side and goes
+		  quadratic. The dual pivot version does about 5% fewer comparisons than quicksort on random data and skips its middle
+		  part once p == q; a large middle part has the copies of p and q moved out of it first, so the duplicates are cheap
+		  as well.
+----------------------------------------------------------------------------------------------------------------------------------------
+
+	Iterative QuickSort
+	--------------------
+		The recursive quickSort goes as deep as its partitions are unbalanced, n levels on a sorted array with the last element
+	  as pivot, which overflows the stack of a thread long before the running time gets unbearable. quickSortIterative keeps
+	  the ranges left to sort on a stack of its own instead: the larger side of every partition is pushed and the smaller
+	  one is sorted first. A pushed range is at least as large as everything sorted before it is popped, so the stack holds
+	  at most log2(n) ranges, a fixed array of QS_STACK_SIZE entries and O(1) of the thread stack. With a ninther or random
+	  pivot 10^8 elements sort fine on a worker thread with a 32 KB stack.
 */
 
 int DEMO_SIZE; 
-int HS_OP, T_HS_OP, T_QS_OP, QS_OP;
+thread_local unsigned long long HS_OP, QS_OP;
 
 Profiler profiler("Demo Heap & Quick");
 
@@ -70,15 +117,6 @@ void initOp() {
 	HS_OP = QS_OP = 0;
 }
 
-void initTOp() {
-	T_HS_OP = T_QS_OP = 0;
-}
-
-void addOp() {
-	T_HS_OP += HS_OP;
-	T_QS_OP += QS_OP;
-}
-
 void swap(int* a, int* b) {
 	int aux;
 
@@ -88,6 +126,7 @@ void swap(int* a, int* b) {
 }
 
 int* generateArray(int size, bool unique, int sorted) {
+	Profiler::ScopedTrace trace(profiler, "generate input");
 	int* a = (int*)malloc(size * sizeof(int));
 
 	FillRandomArray(a, size, 10, 50000, unique, sorted);
@@ -96,6 +135,7 @@ int* generateArray(int size, bool unique, int sorted) {
 }
 
 int* generateCopy(int* a, int size) {
+	Profiler::ScopedTrace trace(profiler, "copy input");
 	int* copy = (int*)malloc(size * sizeof(int));
 
 	for (int i = 0; i < size; i++)
@@ -115,28 +155,30 @@ void printArray(int* a, int size) {
 	printf("\n");
 }
 
+template <typename Count>
 void insertionSort(int* a, int l, int r) {
 
 	for (int i = l; i <= r; i++)
 	{
 		int key = a[i];
-		QS_OP++;
+		Count::add(QS_OP);
 		int j = i - 1;
 
 		while (j >= l && a[j] > key) {
-			QS_OP++;
+			Count::add(QS_OP);
 			swap(&a[j + 1], &a[j]);
-			QS_OP += 3;
+			Count::add(QS_OP, 3);
 			j--;
 		}
-		QS_OP++;
+		Count::add(QS_OP);
 		a[j + 1] = key;
 	}
 }
 
+template <typename Count>
 int partition(int* a, int l, int r) {
 	int piv = a[r];
-	QS_OP++;
+	Count::add(QS_OP);
 	int i = l - 1;
 
 	for (int j = l; j <= r - 1; j++)
@@ -145,32 +187,433 @@ int partition(int* a, int l, int r) {
 		{
 			i++;
 			swap(&a[i], &a[j]);
-			QS_OP += 3;
+			Count::add(QS_OP, 3);
 		}
-		QS_OP++;
+		Count::add(QS_OP);
 	}
 
 	swap(&a[i + 1], &a[r]);
-	QS_OP += 3;
+	Count::add(QS_OP, 3);
 
 	return i + 1;
 }
 
-int randomPartition(int* a, int l, int r) {
-	srand(time(0));
-	int random = l + rand() % (r - l + 1);
+/*
+	Partition kernels
+	------------------
+		The partition the quicksort calls once the pivot is in a[r], both give the same split: a[l..p-1] < pivot <= a[p+1..r].
+			- lomuto: partition, one comparison and one branch per element, the branch is taken at random on random data
+		  and the processor mispredicts about half of them
+			- block (BlockQuicksort, Edelkamp & Weiss): the comparisons of a block of BLOCK_SIZE elements from each end only
+		  write the offsets of the misplaced ones into a buffer, the counter moves by the result of the comparison instead
+		  of a branch; the buffered elements of the two ends are then swapped in bulk, so the only branches left are
+		  the loop ones which are always predicted
+*/
+#define BLOCK_SIZE 64
+
+enum PartitionKernel {
+	PARTITION_LOMUTO = 0, PARTITION_BLOCK = 1, PARTITION_KERNEL_COUNT = 2
+};
+
+const char* PartitionKernelName(int kernel) {
+	switch (kernel) {
+	case PARTITION_LOMUTO: return "lomuto";
+	default: return "block";
+	}
+}
+
+template <typename Count>
+int blockPartition(int* a, int l, int r) {
+	unsigned char offsetsL[BLOCK_SIZE], offsetsR[BLOCK_SIZE];
+	int startL = 0, numL = 0, startR = 0, numR = 0;
+	int piv = a[r];
+	Count::add(QS_OP);
+	int left = l;
+	int right = r - 1;
+
+	// a[l..left-1] < piv and a[right+1..r-1] >= piv, the buffers hold what is misplaced in the current blocks
+	while (right - left + 1 >= 2 * BLOCK_SIZE)
+	{
+		if (numL == 0)
+		{
+			startL = 0;
+			for (int i = 0; i < BLOCK_SIZE; i++)
+			{
+				offsetsL[numL] = (unsigned char)i;
+				numL += a[left + i] >= piv;
+			}
+			Count::add(QS_OP, BLOCK_SIZE);
+		}
+
+		if (numR == 0)
+		{
+			startR = 0;
+			for (int i = 0; i < BLOCK_SIZE; i++)
+			{
+				offsetsR[numR] = (unsigned char)i;
+				numR += a[right - i] < piv;
+			}
+			Count::add(QS_OP, BLOCK_SIZE);
+		}
+
+		int num = numL < numR ? numL : numR;
+
+		for (int j = 0; j < num; j++)
+		{
+			swap(&a[left + offsetsL[startL + j]], &a[right - offsetsR[startR + j]]);
+		}
+		Count::add(QS_OP, 3 * num);
+
+		numL -= num;
+		numR -= num;
+		startL += num;
+		startR += num;
+
+		if (numL == 0)
+		{
+			left += BLOCK_SIZE;
+		}
+		if (numR == 0)
+		{
+			right -= BLOCK_SIZE;
+		}
+	}
+
+	// less than two blocks are left (with the block that still has offsets), a branchless lomuto finishes them
+	int i = left;
+
+	for (int j = left; j <= right; j++)
+	{
+		int x = a[j];
+		a[j] = a[i];
+		a[i] = x;
+		i += x < piv;
+	}
+	Count::add(QS_OP, 4 * (right - left + 1));
+
+	swap(&a[i], &a[r]);
+	Count::add(QS_OP, 3);
+
+	return i;
+}
+
+/*
+	Pivot strategies
+	-----------------
+		The partition always uses a[r] as pivot, a strategy only decides which element is moved there first.
+			- last: a[r] itself, the sorted arrays are the worst case
+			- random: a uniformly random element, O(n*log n) expected on every input
+			- median of 3: the median of a[l], a[middle] and a[r], good on sorted arrays but the median of 3 killer input
+		  still makes it quadratic
+			- ninther (Tukey): the median of the medians of three groups of three elements spread over the range, a much
+		  better estimate of the real median for the cost of 12 comparisons; small ranges use the median of 3
+*/
+enum PivotStrategy {
+	PIVOT_LAST = 0, PIVOT_RANDOM = 1, PIVOT_MEDIAN_OF_3 = 2, PIVOT_NINTHER = 3, PIVOT_STRATEGY_COUNT = 4
+};
+
+const char* PivotStrategyName(int strategy) {
+	switch (strategy) {
+	case PIVOT_LAST: return "last";
+	case PIVOT_RANDOM: return "random";
+	case PIVOT_MEDIAN_OF_3: return "median of 3";
+	default: return "ninther";
+	}
+}
+
+template <typename Count>
+int medianOf3(int* a, int i, int j, int k) {
+	Count::add(QS_OP, 2);
+
+	if (a[i] < a[j])
+	{
+		if (a[j] < a[k])
+		{
+			return j;
+		}
+
+		Count::add(QS_OP);
+		return a[i] < a[k] ? k : i;
+	}
+
+	if (a[i] < a[k])
+	{
+		return i;
+	}
+
+	Count::add(QS_OP);
+	return a[j] < a[k] ? k : j;
+}
+
+/*
+	moves the pivot chosen by the strategy to a[r]
+*/
+template <typename Count>
+void choosePivot(int* a, int l, int r, int strategy) {
+	int middle = l + (r - l) / 2;
+	int pivot = r;
+
+	switch (strategy) {
+	case PIVOT_LAST:
+		return;
+	case PIVOT_RANDOM:
+		pivot = l + (int)RandomEngine().nextBelow(r - l + 1); // stream of the thread, seeded by SetRandomSeed
+		swap(&a[r], &a[pivot]);
+		Count::add(QS_OP, 3);
+		return;
+	case PIVOT_MEDIAN_OF_3:
+		pivot = medianOf3<Count>(a, l, middle, r);
+		break;
+	default:
+		if (r - l + 1 < 40)
+		{
+			pivot = medianOf3<Count>(a, l, middle, r);
+		}
+		else
+		{
+			int step = (r - l + 1) / 8;
+
+			pivot = medianOf3<Count>(a,
+				medianOf3<Count>(a, l, l + step, l + 2 * step),
+				medianOf3<Count>(a, middle - step, middle, middle + step),
+				medianOf3<Count>(a, r - 2 * step, r - step, r));
+		}
+		break;
+	}
+
+	if (pivot != r)
+	{
+		swap(&a[r], &a[pivot]);
+		Count::add(QS_OP, 3);
+	}
+}
+
+template <typename Count>
+int pivotPartition(int* a, int l, int r, int strategy, int kernel = PARTITION_LOMUTO) {
+	choosePivot<Count>(a, l, r, strategy);
+
+	if (kernel == PARTITION_BLOCK)
+	{
+		return blockPartition<Count>(a, l, r);
+	}
+
+	return partition<Count>(a, l, r);
+}
+
+/*
+	Dutch national flag partition around the pivot a[r]: a[l..lt-1] < pivot, a[lt..gt] == pivot and a[gt+1..r] > pivot
+*/
+template <typename Count>
+void partition3Way(int* a, int l, int r, int& lt, int& gt) {
+	int piv = a[r];
+	Count::add(QS_OP);
+	int i = l;
+
+	lt = l;
+	gt = r;
+
+	while (i <= gt)
+	{
+		Count::add(QS_OP);
+		if (a[i] < piv)
+		{
+			swap(&a[lt], &a[i]);
+			Count::add(QS_OP, 3);
+			lt++;
+			i++;
+		}
+		else
+		{
+			Count::add(QS_OP);
+			if (a[i] > piv)
+			{
+				swap(&a[i], &a[gt]);
+				Count::add(QS_OP, 3);
+				gt--;
+			}
+			else
+			{
+				i++;
+			}
+		}
+	}
+}
+
+template <typename Count>
+void quickSort3Way(int* a, int l, int r, int strategy) {
+	while (r - l + 1 > 5)
+	{
+		int lt, gt;
+
+		choosePivot<Count>(a, l, r, strategy);
+		partition3Way<Count>(a, l, r, lt, gt);
+
+		// recursion on the smaller side only, the stack stays logarithmic
+		if (lt - l < r - gt)
+		{
+			quickSort3Way<Count>(a, l, lt - 1, strategy);
+			l = gt + 1;
+		}
+		else
+		{
+			quickSort3Way<Count>(a, gt + 1, r, strategy);
+			r = lt - 1;
+		}
+	}
+
+	insertionSort<Count>(a, l, r);
+}
+
+/*
+	Yaroslavskiy's partition around the pivots p = a[l] <= q = a[r]:
+	a[l+1..lt-1] < p, a[lt..gt] between p and q and a[gt+1..r-1] > q, then both pivots are moved to their places
+*/
+template <typename Count>
+void dualPivotQuickSort(int* a, int l, int r) {
+	while (r - l + 1 > 5)
+	{
+		// the tertiles as pivots, the ends themselves would make the sorted arrays quadratic
+		int third = (r - l + 1) / 3;
+		swap(&a[l], &a[l + third]);
+		swap(&a[r], &a[r - third]);
+		Count::add(QS_OP, 6);
+
+		Count::add(QS_OP);
+		if (a[l] > a[r])
+		{
+			swap(&a[l], &a[r]);
+			Count::add(QS_OP, 3);
+		}
+
+		int p = a[l];
+		int q = a[r];
+		Count::add(QS_OP, 2);
+		int lt = l + 1;
+		int gt = r - 1;
+
+		for (int k = lt; k <= gt; k++)
+		{
+			Count::add(QS_OP);
+			if (a[k] < p)
+			{
+				swap(&a[k], &a[lt]);
+				Count::add(QS_OP, 3);
+				lt++;
+			}
+			else
+			{
+				Count::add(QS_OP);
+				if (a[k] > q)
+				{
+					while (k < gt && a[gt] > q)
+					{
+						Count::add(QS_OP);
+						gt--;
+					}
+					Count::add(QS_OP);
+
+					swap(&a[k], &a[gt]);
+					Count::add(QS_OP, 3);
+					gt--;
+
+					Count::add(QS_OP);
+					if (a[k] < p)
+					{
+						swap(&a[k], &a[lt]);
+						Count::add(QS_OP, 3);
+						lt++;
+					}
+				}
+			}
+		}
+
+		lt--;
+		gt++;
+		swap(&a[l], &a[lt]);
+		swap(&a[r], &a[gt]);
+		Count::add(QS_OP, 6);
+
+		int less = lt + 1;
+		int great = gt - 1;
+
+		// when p == q the middle only holds copies of the pivots and is left out
+		Count::add(QS_OP);
+		if (p == q)
+		{
+			great = less - 1;
+		}
+		// a large middle is mostly copies of p and q (few distinct keys), they are moved to its ends first,
+		// otherwise the same two pivots would be picked again and again
+		else if (great - less + 1 > 4 * (r - l + 1) / 7)
+		{
+			for (int k = less; k <= great; k++)
+			{
+				Count::add(QS_OP);
+				if (a[k] == p)
+				{
+					swap(&a[k], &a[less]);
+					Count::add(QS_OP, 3);
+					less++;
+				}
+				else
+				{
+					Count::add(QS_OP);
+					if (a[k] == q)
+					{
+						while (k < great && a[great] == q)
+						{
+							Count::add(QS_OP);
+							great--;
+						}
+						Count::add(QS_OP);
+
+						swap(&a[k], &a[great]);
+						Count::add(QS_OP, 3);
+						great--;
+
+						Count::add(QS_OP);
+						if (a[k] == p)
+						{
+							swap(&a[k], &a[less]);
+							Count::add(QS_OP, 3);
+							less++;
+						}
+					}
+				}
+			}
+		}
+
+		// recursion on the two smaller parts only, the largest one is sorted by the loop
+		int parts[3][2] = { { l, lt - 1 }, { less, great }, { gt + 1, r } };
+		int largest = 0;
+		for (int k = 1; k < 3; k++)
+		{
+			if (parts[k][1] - parts[k][0] > parts[largest][1] - parts[largest][0])
+			{
+				largest = k;
+			}
+		}
+		for (int k = 0; k < 3; k++)
+		{
+			if (k != largest)
+			{
+				dualPivotQuickSort<Count>(a, parts[k][0], parts[k][1]);
+			}
+		}
 
-	swap(&a[r], &a[random]);
-	QS_OP += 3;
+		l = parts[largest][0];
+		r = parts[largest][1];
+	}
 
-	return partition(a, l, r);
+	insertionSort<Count>(a, l, r);
 }
 
-void quickSort(int* a, int l, int r, bool demo) {
+template <typename Count>
+void quickSort(int* a, int l, int r, bool demo, int strategy = PIVOT_LAST, int kernel = PARTITION_LOMUTO) {
 	if (r >= l)
 	{
 		if (r - l + 1 <= 5) {
-			insertionSort(a, l, r);
+			insertionSort<Count>(a, l, r);
 
 			if (demo)
 			{
@@ -180,8 +623,7 @@ void quickSort(int* a, int l, int r, bool demo) {
 			}
 		}
 		else {
-		//	int p = randomPartition(a, l, r);
-			int p = partition(a, l, r);
+			int p = pivotPartition<Count>(a, l, r, strategy, kernel);
 
 			if (demo)
 			{
@@ -190,12 +632,64 @@ void quickSort(int* a, int l, int r, bool demo) {
 				printf("\n");
 			}
 
-			quickSort(a, l, p - 1, demo);
-			quickSort(a, p + 1, r, demo);
+			quickSort<Count>(a, l, p - 1, demo, strategy, kernel);
+			quickSort<Count>(a, p + 1, r, demo, strategy, kernel);
+		}
+	}
+}
+
+/*
+	Every range on the stack is at least as large as all the ranges sorted after it, so each one is at most half of the
+	one below it and 64 entries are enough for any int size
+*/
+#define QS_STACK_SIZE 64
+
+/*
+	quickSort without recursion, the larger side of every partition is pushed on an explicit stack and the smaller
+	one is sorted right away, thus the stack never holds more than log2(n) ranges whatever the pivots are
+*/
+template <typename Count>
+void quickSortIterative(int* a, int size, int strategy = PIVOT_LAST, int kernel = PARTITION_LOMUTO) {
+	int stackL[QS_STACK_SIZE], stackR[QS_STACK_SIZE];
+	int top = 0;
+	int l = 0;
+	int r = size - 1;
+
+	for (;;)
+	{
+		while (r - l + 1 > 5)
+		{
+			int p = pivotPartition<Count>(a, l, r, strategy, kernel);
+
+			if (p - l < r - p)
+			{
+				stackL[top] = p + 1;
+				stackR[top] = r;
+				r = p - 1;
+			}
+			else
+			{
+				stackL[top] = l;
+				stackR[top] = p - 1;
+				l = p + 1;
+			}
+			top++;
+		}
+
+		insertionSort<Count>(a, l, r);
+
+		if (top == 0)
+		{
+			return;
 		}
+
+		top--;
+		l = stackL[top];
+		r = stackR[top];
 	}
 }
 
+template <typename Count>
 void heapify(int* a, int size, int root) {
 	int right = 2 * root + 2;
 	int left = 2 * root + 1;
@@ -205,58 +699,144 @@ void heapify(int* a, int size, int root) {
 	{
 		index = left;
 	}
-	HS_OP++;
+	Count::add(HS_OP);
 
 	if (right < size && a[index] < a[right])
 	{
 		index = right;
 	}
-	HS_OP++;
+	Count::add(HS_OP);
 
 	if (index != root)
 	{
 		swap(&a[root], &a[index]);
-		HS_OP += 3;
-		heapify(a, size, index);
+		Count::add(HS_OP, 3);
+		heapify<Count>(a, size, index);
 	}
 }
 
-void buildHeapBottomUp(int* a, int size, bool demo) {
+template <typename Count>
+void buildHeapBottomUp(int* a, int size) {
 	for (int i = size / 2 - 1; i >= 0; i--)
 	{
-		heapify(a, size, i);
+		heapify<Count>(a, size, i);
 	}
 }
 
-void heapSort(int* a, int size, bool demo) {
+template <typename Count>
+void heapSort(int* a, int size) {
 	int heapSize = size;
 
-	buildHeapBottomUp(a, heapSize, demo);
+	buildHeapBottomUp<Count>(a, heapSize);
 
 	for (int i = size - 1; i > 0; i--)
 	{
 		swap(&a[0], &a[i]);
-		HS_OP += 3;
+		Count::add(HS_OP, 3);
 
 		heapSize--;
 
-		heapify(a, heapSize, 0);
+		heapify<Count>(a, heapSize, 0);
+	}
+}
+
+template <typename Count>
+void introSortLoop(int* a, int l, int r, int depthLimit, int strategy) {
+	while (r - l + 1 > 5)
+	{
+		if (depthLimit == 0)
+		{
+			heapSort<Count>(a + l, r - l + 1);
+			return;
+		}
+		depthLimit--;
+
+		int p = pivotPartition<Count>(a, l, r, strategy);
+
+		if (p - l < r - p)
+		{
+			introSortLoop<Count>(a, l, p - 1, depthLimit, strategy);
+			l = p + 1;
+		}
+		else
+		{
+			introSortLoop<Count>(a, p + 1, r, depthLimit, strategy);
+			r = p - 1;
+		}
+	}
+
+	insertionSort<Count>(a, l, r);
+}
+
+template <typename Count>
+void introSort(int* a, int size, int strategy = PIVOT_LAST) {
+	int log2n = 0;
+
+	for (int n = size; n > 1; n /= 2)
+	{
+		log2n++;
+	}
+
+	introSortLoop<Count>(a, 0, size - 1, 2 * log2n, strategy);
+}
+
+/*
+	The ways quickSortMode can sort, the counted versions add to QS_OP (and to HS_OP when heapsort is involved)
+	the single pivot modes pick their pivot with the given strategy, the dual pivot one always uses the tertiles
+*/
+enum QuickSortMode {
+	QS_CLASSIC = 0, QS_INTRO = 1, QS_THREE_WAY = 2, QS_DUAL_PIVOT = 3, QS_BLOCK = 4, QS_ITERATIVE = 5, QS_MODE_COUNT = 6
+};
+
+const char* QuickSortModeName(int mode) {
+	switch (mode) {
+	case QS_CLASSIC: return "QuickSort";
+	case QS_INTRO: return "IntroSort";
+	case QS_THREE_WAY: return "QuickSort 3-way";
+	case QS_DUAL_PIVOT: return "Dual-Pivot QuickSort";
+	case QS_BLOCK: return "Block QuickSort";
+	default: return "Iterative QuickSort";
+	}
+}
+
+template <typename Count>
+void quickSortMode(int* a, int size, int mode, int strategy = PIVOT_LAST) {
+	switch (mode) {
+	case QS_CLASSIC:
+		quickSort<Count>(a, 0, size - 1, false, strategy);
+		break;
+	case QS_INTRO:
+		introSort<Count>(a, size, strategy);
+		break;
+	case QS_THREE_WAY:
+		quickSort3Way<Count>(a, 0, size - 1, strategy);
+		break;
+	case QS_DUAL_PIVOT:
+		dualPivotQuickSort<Count>(a, 0, size - 1);
+		break;
+	case QS_BLOCK:
+		quickSort<Count>(a, 0, size - 1, false, strategy, PARTITION_BLOCK);
+		break;
+	default:
+		quickSortIterative<Count>(a, size, strategy);
+		break;
 	}
 }
 
-int quickSelect(int* a, int l, int r, int index, bool demo) {
+template <typename Count>
+int quickSelect(int* a, int l, int r, int index, bool demo, int strategy = PIVOT_RANDOM) {
 	if (r == l)
 	{
 		return a[l];
 	}
 	else
 	{
-		int q = randomPartition(a, l, r);
+		int q = pivotPartition<Count>(a, l, r, strategy);
 
 		if (demo)
 		{
 			printf("The array after partition q = %d and element = %d: ", q, a[q]); // Used for demo
-			printArray(a + l, r + 1);
+			printArray(a + l, r - l + 1);
 			printf("\n");
 		}
 
@@ -267,11 +847,11 @@ int quickSelect(int* a, int l, int r, int index, bool demo) {
 
 		if (q < index)
 		{
-			quickSelect(a, q + 1, r, index, demo);
+			return quickSelect<Count>(a, q + 1, r, index, demo, strategy);
 		}
 		else
 		{
-			quickSelect(a, l, q - 1, index, demo);
+			return quickSelect<Count>(a, l, q - 1, index, demo, strategy);
 		}
 	}
 }
@@ -288,7 +868,7 @@ void demoQuickSort() {
 	printArray(a, DEMO_SIZE);
 	printf("\n");
 
-	quickSort(a, 0, DEMO_SIZE - 1, true);
+	quickSort<NullPolicy>(a, 0, DEMO_SIZE - 1, true);
 
 	printf("Final form: ");
 	printArray(a, DEMO_SIZE);
@@ -300,8 +880,7 @@ void demoQuickSelect() {
 	DEMO_SIZE = 50;
 	int* a = (int*)malloc(DEMO_SIZE * sizeof(int));
 	
-	srand(time(0));
-	int randomIndex = rand() % DEMO_SIZE;
+	int randomIndex = (int)RandomEngine().nextBelow(DEMO_SIZE);
 
 	FillRandomArray(a, DEMO_SIZE, 10, 1000, false, 0);
 	int* copy = generateCopy(a, DEMO_SIZE);
@@ -312,13 +891,13 @@ void demoQuickSelect() {
 	printArray(a, DEMO_SIZE);
 	printf("\n");
 
-	quickSort(copy, 0, DEMO_SIZE - 1, false);
+	quickSort<NullPolicy>(copy, 0, DEMO_SIZE - 1, false);
 
 	printf("Initial array sorted: ");
 	printArray(copy, DEMO_SIZE);
 	printf("\n");
 
-	int element = quickSelect(a, 0, DEMO_SIZE - 1, randomIndex, true);
+	int element = quickSelect<NullPolicy>(a, 0, DEMO_SIZE - 1, randomIndex, true);
 
 	printf("The %dth element is: %d\n",randomIndex, element);
 
@@ -326,80 +905,280 @@ void demoQuickSelect() {
 }
 
 void generateChartAverage() {
-	int* a;
-	int* sample;
+	Profiler::ScopedTrace trace(profiler, "average case");
 
-	for (int size = 100; size < 10000; size += 100)
-	{
-		initTOp();
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
+		int* sample;
 
-		for (int j = 0; j < 5; j++) {
+		for (BenchmarkRunner run(profiler, size); run.next(); ) {
 			a = generateArray(size, false, 0);
 
 			initOp();
 
 			sample = generateCopy(a, size);
-			heapSort(sample, size, false);
+			profiler.beginTrace("heapSort counted");
+			heapSort<CountingPolicy>(sample, size);
+			profiler.endTrace();
 			free(sample);
 
 			sample = generateCopy(a, size);
-			quickSort(sample, 0, size - 1, false);
+			profiler.beginTrace("quickSort counted");
+			quickSort<CountingPolicy>(sample, 0, size - 1, false);
+			profiler.endTrace();
 			free(sample);
 
-			free(a);
+			run.record(HS_AVG, HS_OP);
+			run.record(QS_AVG, QS_OP);
 
-			addOp();
-		}
+			initOp();
 
-		profiler.countOperation(HS_AVG, size, T_HS_OP / 5);
-		profiler.countOperation(QS_AVG, size, T_QS_OP / 5);
-	}
+			sample = generateCopy(a, size);
+			profiler.beginTrace("introSort counted");
+			introSort<CountingPolicy>(sample, size);
+			profiler.endTrace();
+			free(sample);
+
+			run.record(IS_AVG, QS_OP + HS_OP);
+
+			initOp();
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("block quickSort counted");
+			quickSort<CountingPolicy>(sample, 0, size - 1, false, PIVOT_LAST, PARTITION_BLOCK);
+			profiler.endTrace();
+			free(sample);
+
+			run.record(BQS_AVG, QS_OP);
+
+			// the timed runs use the uninstrumented kernels
+			sample = generateCopy(a, size);
+			profiler.beginTrace("heapSort timed");
+			run.time(HS_AVG, [&]() { heapSort<NullPolicy>(sample, size); });
+			profiler.endTrace();
+			free(sample);
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("quickSort timed");
+			run.time(QS_AVG, [&]() { quickSort<NullPolicy>(sample, 0, size - 1, false); });
+			profiler.endTrace();
+			free(sample);
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("introSort timed");
+			run.time(IS_AVG, [&]() { introSort<NullPolicy>(sample, size); });
+			profiler.endTrace();
+			free(sample);
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("block quickSort timed");
+			run.time(BQS_AVG, [&]() { quickSort<NullPolicy>(sample, 0, size - 1, false, PIVOT_LAST, PARTITION_BLOCK); });
+			profiler.endTrace();
+			free(sample);
+
+			free(a);
+		}
+	});
 }
 
 void generateChartBest() {
-	int* a;
+	Profiler::ScopedTrace trace(profiler, "best case");
+
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		initOp();
 
 		a = generateArray(size, false, 0);
-		quickSort(a, 0, size - 1, false);
+		profiler.beginTrace("quickSort counted");
+		quickSort<CountingPolicy>(a, 0, size - 1, false);
+		profiler.endTrace();
 		free(a);
 
 		profiler.countOperation(QS_BEST, size, QS_OP);
-	}
+	});
 }
 
 void generateChartWorst() {
-	int* a;
+	Profiler::ScopedTrace trace(profiler, "worst case");
+
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
 
-	for (int size = 100; size < 10000; size += 100)
-	{
 		initOp();
 
 		a = generateArray(size, false, 1);
-		quickSort(a, 0, size - 1, false);
+		profiler.beginTrace("quickSort counted");
+		quickSort<CountingPolicy>(a, 0, size - 1, false);
+		profiler.endTrace();
 		free(a);
 
 		profiler.countOperation(QS_WORST_ASC, size, QS_OP);
-	}
 
-	for (int size = 100; size < 10000; size += 100)
-	{
+		initOp();
+
+		a = generateArray(size, false, 1);
+		profiler.beginTrace("introSort counted");
+		introSort<CountingPolicy>(a, size);
+		profiler.endTrace();
+		free(a);
+
+		profiler.countOperation(IS_WORST_ASC, size, QS_OP + HS_OP);
+	});
+
+	ParallelSweep(100, 9900, 100, [](int size) {
+		int* a;
+
 		initOp();
 
 		a = generateArray(size, false, 2);
-		quickSort(a, 0, size - 1, false);
+		profiler.beginTrace("quickSort counted");
+		quickSort<CountingPolicy>(a, 0, size - 1, false);
+		profiler.endTrace();
 		free(a);
 
 		profiler.countOperation(QS_WORST_DESC, size, QS_OP);
+
+		initOp();
+
+		a = generateArray(size, false, 2);
+		profiler.beginTrace("introSort counted");
+		introSort<CountingPolicy>(a, size);
+		profiler.endTrace();
+		free(a);
+
+		profiler.countOperation(IS_WORST_DESC, size, QS_OP + HS_OP);
+	});
+}
+
+void generateChartDistributions() {
+	Profiler::ScopedTrace trace(profiler, "distributions");
+
+	for (int method = NEARLY_SORTED; method < SORT_METHOD_COUNT; method++)
+	{
+		std::string hsName = std::string("HeapSort ") + SortMethodName(method);
+		std::string qsName = std::string("QuickSort ") + SortMethodName(method);
+		std::string isName = std::string("IntroSort ") + SortMethodName(method);
+
+		ParallelSweep(100, 9900, 100, [&](int size) {
+			int* a;
+			int* sample;
+
+			initOp();
+
+			a = generateArray(size, false, method);
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("heapSort counted");
+			heapSort<CountingPolicy>(sample, size);
+			profiler.endTrace();
+			free(sample);
+
+			sample = generateCopy(a, size);
+
+			profiler.beginTrace("quickSort counted");
+			quickSort<CountingPolicy>(a, 0, size - 1, false);
+			profiler.endTrace();
+			free(a);
+
+			profiler.countOperation(hsName.c_str(), size, HS_OP);
+			profiler.countOperation(qsName.c_str(), size, QS_OP);
+
+			initOp();
+
+			profiler.beginTrace("introSort counted");
+			introSort<CountingPolicy>(sample, size);
+			profiler.endTrace();
+			free(sample);
+
+			profiler.countOperation(isName.c_str(), size, QS_OP + HS_OP);
+		});
+
+		profiler.createGroup((std::string("Distribution ") + SortMethodName(method)).c_str(), hsName.c_str(), qsName.c_str(), isName.c_str());
+	}
+}
+
+void generateChartPivots() {
+	Profiler::ScopedTrace trace(profiler, "pivot strategies");
+
+	for (int method = UNSORTED; method < SORT_METHOD_COUNT; method++)
+	{
+		std::vector<std::string> names;
+
+		for (int strategy = PIVOT_LAST; strategy < PIVOT_STRATEGY_COUNT; strategy++)
+		{
+			names.push_back(std::string("QuickSort ") + PivotStrategyName(strategy) + " pivot " + SortMethodName(method));
+		}
+
+		ParallelSweep(100, 9900, 100, [&](int size) {
+			int* a;
+			int* sample;
+
+			a = generateArray(size, false, method);
+
+			for (int strategy = PIVOT_LAST; strategy < PIVOT_STRATEGY_COUNT; strategy++)
+			{
+				initOp();
+
+				sample = generateCopy(a, size);
+				profiler.beginTrace("quickSort counted");
+				quickSort<CountingPolicy>(sample, 0, size - 1, false, strategy);
+				profiler.endTrace();
+				free(sample);
+
+				profiler.countOperation(names[strategy].c_str(), size, QS_OP);
+			}
+
+			free(a);
+		});
+
+		profiler.createGroup((std::string("Pivots ") + SortMethodName(method)).c_str(), names);
+	}
+}
+
+void generateChartDuplicates() {
+	Profiler::ScopedTrace trace(profiler, "duplicate keys");
+	std::vector<std::string> names;
+
+	for (int mode = QS_CLASSIC; mode < QS_MODE_COUNT; mode++)
+	{
+		names.push_back(std::string(QuickSortModeName(mode)) + " Duplicates");
 	}
+
+	ParallelSweep(100, 9900, 100, [&](int size) {
+		int* a = (int*)malloc(size * sizeof(int));
+		int* sample;
+
+		FillRandomArray(a, size, DUPLICATES_MIN, DUPLICATES_MAX, false, UNSORTED);
+
+		for (int mode = QS_CLASSIC; mode < QS_MODE_COUNT; mode++)
+		{
+			initOp();
+
+			sample = generateCopy(a, size);
+			profiler.beginTrace("quickSortMode counted");
+			quickSortMode<CountingPolicy>(sample, size, mode);
+			profiler.endTrace();
+			free(sample);
+
+			profiler.countOperation(names[mode].c_str(), size, QS_OP + HS_OP);
+		}
+
+		free(a);
+	});
+
+	profiler.createGroup("Duplicate Keys", names);
 }
 
 void generateCharts() {
+	profiler.enableHardwareCounters(); // Linux only, the hardware series are missing otherwise
+	profiler.setReportOutput(Profiler::REPORT_HTML | Profiler::REPORT_TRACE); // timeline of the phases, per thread
+
 	generateChartAverage();
-	profiler.createGroup("Average Case QuickSort HeapSort", HS_AVG, QS_AVG);
+	profiler.createGroup("Average Case QuickSort HeapSort", HS_AVG, QS_AVG, IS_AVG, BQS_AVG);
+	profiler.createGroup("Average Case L1D Misses", HS_AVG " L1D misses", QS_AVG " L1D misses", IS_AVG " L1D misses", BQS_AVG " L1D misses");
+	profiler.createGroup("Average Case Branch Misses", HS_AVG " branch misses", QS_AVG " branch misses", IS_AVG " branch misses",
+		BQS_AVG " branch misses");
 
 	profiler.reset("Demo Quick");
 
@@ -407,13 +1186,30 @@ void generateCharts() {
 	generateChartWorst();
 
 	profiler.createGroup("Worst And Best Case QuickSort", QS_WORST_ASC, QS_WORST_DESC);
+	profiler.createGroup("Worst Case IntroSort", IS_WORST_ASC, IS_WORST_DESC);
+
+	profiler.reset("Demo Distributions");
+
+	generateChartDistributions();
+
+	profiler.reset("Demo Pivots");
+
+	generateChartPivots();
+
+	profiler.reset("Demo Duplicates");
+
+	generateChartDuplicates();
 
 	profiler.showReport();
 }
 
-void main() {
+#ifndef BENCHMARK_DRIVER
+int main() {
 	demoQuickSort();
 	demoQuickSelect();
 
 	generateCharts();
+
+	return profiler.hasRegressions() ? 1 : 0;
 }
+#endif
@@ -1,6 +1,8 @@
 #include<stdlib.h>
 #include<stdio.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
+
+#define RB_DELETE_NS "RBDelete latency ns"
 
 Profiler profiler("RB_Tree");
 
@@ -438,7 +440,40 @@ int* generateArray(int size) {
 	return NULL;
 }
 
-void main() {
+void generateChart() {
+	ParallelSweep(1000, 10000, 1000, [](int size) {
+		int* a = (int*)malloc(size * sizeof(int));
+		int* index = (int*)malloc(size * sizeof(int));
+		Profiler::Histogram& latency = profiler.histogram(RB_DELETE_NS, size);
+
+		FillRandomArray(a, size, 1, 10 * size, true, 0);
+		FillRandomArray(index, size, 0, size - 1, true, 0);
+
+		RBTree* T = createTree();
+
+		for (int i = 0; i < size; i++)
+		{
+			RbInsert(T, a[i]);
+		}
+
+		for (int i = 0; i < size; i++)
+		{
+			NodeRB* nodeToDelete = searchKey(T, a[index[i]]);
+
+			latency.time([&]() { RBDelete(T, nodeToDelete); });
+		}
+
+		free(T->null);
+		free(T);
+		free(index);
+		free(a);
+	});
+
+	profiler.showReport();
+}
+
+#ifndef BENCHMARK_DRIVER
+int main() {
 
 	int size = 10;
 	int* a = generateArray(size);
@@ -472,4 +507,9 @@ void main() {
 		printTree(T, T->root, 1);
 		printf("\n-------------------------------------------------------------------------------------------------------------------\n");
 	}
-}
\ No newline at end of file
+
+	generateChart();
+
+	return profiler.hasRegressions() ? 1 : 0;
+}
+#endif
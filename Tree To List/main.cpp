@@ -1,6 +1,6 @@
 #include<stdlib.h>
 #include<stdio.h>
-#include "Profiler.h"
+#include "../Profiler/Profiler.h"
 
 Profiler profiler("OS Tree");
 